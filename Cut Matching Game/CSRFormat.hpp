@@ -0,0 +1,29 @@
+//
+//  CSRFormat.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Binary CSR graph format written by cmg-gen, so big inputs don't have to go through the Chaco text parser.
+// Layout (native endianness): CSRHeader, then nodeCount + 1 uint64 row offsets, then arcCount uint32 neighbors.
+// Graphs are undirected and unit capacity, so every edge shows up in both of its endpoints' rows. Nodes are 0-indexed.
+
+#ifndef CSRFormat_hpp
+#define CSRFormat_hpp
+
+#include <cstdint>
+
+inline constexpr char CSR_MAGIC[8] = {'C', 'M', 'G', 'C', 'S', 'R', '\0', '\0'};
+inline constexpr uint32_t CSR_VERSION = 1;
+
+struct CSRHeader {
+    char magic[8];
+    uint32_t version;
+    // unused for now, kept so the offsets stay 8 byte aligned
+    uint32_t flags;
+    uint64_t nodeCount;
+    // directed arcs, so twice the number of edges
+    uint64_t arcCount;
+};
+
+#endif /* CSRFormat_hpp */
@@ -0,0 +1,140 @@
+//
+//  Certificate.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "Certificate.hpp"
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+
+namespace {
+
+const char MAGIC[8] = {'C', 'M', 'G', 'C', 'E', 'R', 'T', '\0'};
+const uint32_t VERSION = 1;
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void writeVector(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+}
+
+EmbeddingCertificate::EmbeddingCertificate(const Graph& graph) : nodeCount(graph.nodeCount()) {
+    this->arcOffsets.resize(this->nodeCount + 1, 0);
+    for (int node = 0; node < this->nodeCount; node++) {
+        this->arcOffsets[node + 1] = this->arcOffsets[node] + graph.adjacencyList[node].size();
+    }
+    this->arcEdgeIds.resize(this->arcOffsets.back(), -1);
+
+    // an edge gets its id from the row of its lower endpoint. Since rows are visited in order, the ids waiting for each higher
+    // endpoint are sorted by the lower endpoint, so they line up with that row's arcs back to lower nodes once those are sorted too.
+    // Graph::load turns away graphs where they wouldn't, see Graph::isSymmetric
+    std::vector<std::vector<int32_t>> waitingIds(this->nodeCount);
+    std::vector<int> lowerArcs;
+    for (int node = 0; node < this->nodeCount; node++) {
+        const auto& neighbors = graph.adjacencyList[node];
+        lowerArcs.clear();
+        for (int arc = 0; arc < static_cast<int>(neighbors.size()); arc++) {
+            int to = neighbors[arc].to_vertex;
+            if (to > node) {
+                int32_t id = static_cast<int32_t>(this->edgeEndpoints.size());
+                this->edgeEndpoints.push_back({node, to});
+                this->arcEdgeIds[this->arcOffsets[node] + arc] = id;
+                waitingIds[to].push_back(id);
+            } else {
+                lowerArcs.push_back(arc);
+            }
+        }
+        std::sort(lowerArcs.begin(), lowerArcs.end(), [&neighbors](int left, int right) {
+            return neighbors[left].to_vertex < neighbors[right].to_vertex;
+        });
+        assert(lowerArcs.size() == waitingIds[node].size());
+        for (size_t index = 0; index < lowerArcs.size(); index++) {
+            this->arcEdgeIds[this->arcOffsets[node] + lowerArcs[index]] = waitingIds[node][index];
+        }
+        std::vector<int32_t>().swap(waitingIds[node]);
+    }
+
+    this->congestion.resize(this->edgeEndpoints.size(), 0);
+    this->pathOffsets.push_back(0);
+    this->roundOffsets.push_back(0);
+}
+
+void EmbeddingCertificate::beginRound() {
+    // roundOffsets always ends with the end of the last round, so a new round just repeats it
+    this->roundOffsets.push_back(this->roundOffsets.back());
+}
+
+void EmbeddingCertificate::addPath(int from, int to, const std::vector<std::pair<int, int>>& arcs) {
+    for (auto [node, arc] : arcs) {
+        int32_t id = this->arcEdgeIds[this->arcOffsets[node] + arc];
+        this->pathEdges.push_back(id);
+        this->highestCongestion = std::max(this->highestCongestion, ++this->congestion[id]);
+    }
+    this->pathOffsets.push_back(this->pathEdges.size());
+    this->pathEndpoints.push_back({from, to});
+    this->roundOffsets.back()++;
+}
+
+int EmbeddingCertificate::roundCount() const {
+    return static_cast<int>(this->roundOffsets.size()) - 1;
+}
+
+uint32_t EmbeddingCertificate::maxCongestion() const {
+    return this->highestCongestion;
+}
+
+bool EmbeddingCertificate::write(const std::string& path, uint64_t graphFingerprint, int phiInverse, const std::vector<int>* originalIds, std::ostream& errors) const {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        errors << "Error opening certificate (" << path << ") for writing\n";
+        return false;
+    }
+    output.write(MAGIC, sizeof(MAGIC));
+    writeValue(output, VERSION);
+    writeValue(output, static_cast<int32_t>(this->nodeCount));
+    writeValue(output, static_cast<int32_t>(phiInverse));
+    writeValue(output, static_cast<uint32_t>(this->roundCount()));
+    writeValue(output, graphFingerprint);
+    writeValue(output, static_cast<uint64_t>(this->edgeEndpoints.size()));
+    writeValue(output, static_cast<uint64_t>(this->pathEndpoints.size()));
+    writeValue(output, static_cast<uint64_t>(this->pathEdges.size()));
+    writeValue(output, this->highestCongestion);
+
+    if (originalIds) {
+        // edges still have to be written lower id first
+        std::vector<std::pair<int32_t, int32_t>> renamed(this->edgeEndpoints.size());
+        for (size_t edge = 0; edge < renamed.size(); edge++) {
+            int32_t u = (*originalIds)[this->edgeEndpoints[edge].first];
+            int32_t v = (*originalIds)[this->edgeEndpoints[edge].second];
+            renamed[edge] = {std::min(u, v), std::max(u, v)};
+        }
+        writeVector(output, renamed);
+        writeVector(output, this->roundOffsets);
+        renamed.resize(this->pathEndpoints.size());
+        for (size_t path = 0; path < renamed.size(); path++) {
+            renamed[path] = {(*originalIds)[this->pathEndpoints[path].first], (*originalIds)[this->pathEndpoints[path].second]};
+        }
+        writeVector(output, renamed);
+    } else {
+        writeVector(output, this->edgeEndpoints);
+        writeVector(output, this->roundOffsets);
+        writeVector(output, this->pathEndpoints);
+    }
+    writeVector(output, this->pathOffsets);
+    writeVector(output, this->pathEdges);
+
+    if (!output) {
+        errors << "Error writing certificate (" << path << ")\n";
+        return false;
+    }
+    return true;
+}
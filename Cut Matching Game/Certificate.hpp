@@ -0,0 +1,51 @@
+//
+//  Certificate.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Keeps the flow paths that embed every round's matching into the graph, so an expander result can be audited.
+// Paths are stored as edge id sequences in one arena (with per-path and per-round offsets into it), and the congestion of every
+// edge is updated as paths come in. Memory is 4 bytes per edge of every path, plus 16 bytes per path and 4 bytes per edge.
+
+#ifndef Certificate_hpp
+#define Certificate_hpp
+
+#include "Graph.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class EmbeddingCertificate {
+public:
+    // numbers the undirected edges of graph. Edge i joins edgeEndpoints[i].first < edgeEndpoints[i].second
+    explicit EmbeddingCertificate(const Graph& graph);
+    void beginRound();
+    // adds a path embedding the matched pair (from, to). arcs are (node, adjacency index) pairs in the graph, starting at from
+    void addPath(int from, int to, const std::vector<std::pair<int, int>>& arcs);
+    int roundCount() const;
+    uint32_t maxCongestion() const;
+    // writes the certificate, see scripts/verify_certificate.py for the layout and what's checked.
+    // If originalIds is given, nodes are written as originalIds[node] (for a graph that was relabeled after loading)
+    bool write(const std::string& path, uint64_t graphFingerprint, int phiInverse, const std::vector<int>* originalIds, std::ostream& errors) const;
+private:
+    // index of each node's first arc, and the edge id of every arc (in adjacency list order)
+    std::vector<uint64_t> arcOffsets;
+    std::vector<int32_t> arcEdgeIds;
+    std::vector<std::pair<int32_t, int32_t>> edgeEndpoints;
+    int nodeCount;
+
+    // edge ids of every path, back to back
+    std::vector<int32_t> pathEdges;
+    // pathOffsets[p] is where path p starts in pathEdges (with one extra entry at the end)
+    std::vector<uint64_t> pathOffsets;
+    std::vector<std::pair<int32_t, int32_t>> pathEndpoints;
+    // roundOffsets[r] is the first path of round r (with one extra entry at the end)
+    std::vector<uint64_t> roundOffsets;
+
+    std::vector<uint32_t> congestion;
+    uint32_t highestCongestion = 0;
+};
+
+#endif /* Certificate_hpp */
@@ -0,0 +1,223 @@
+//
+//  Checkpoint.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "Checkpoint.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+const char MAGIC[8] = {'C', 'M', 'G', 'C', 'K', 'P', 'T', '\0'};
+const uint32_t VERSION = 6;
+// marks the start of every round record
+const uint32_t ROUND_TAG = 0x524e4421;
+// far longer than the text form of a std::mt19937, so a longer string is a corrupt length
+const uint32_t MAX_STRING_LENGTH = 1 << 16;
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void writeString(std::ofstream& out, const std::string& value) {
+    writeValue(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), value.size());
+}
+
+bool readString(std::ifstream& in, std::string& value) {
+    uint32_t length;
+    if (!readValue(in, length) || length > MAX_STRING_LENGTH) {
+        return false;
+    }
+    value.resize(length);
+    return static_cast<bool>(in.read(value.data(), length));
+}
+
+}
+
+Checkpoint::Checkpoint(std::string path, std::ostream& errors) : path(std::move(path)), errors(errors) { }
+
+void Checkpoint::setFlushInterval(int flushInterval) {
+    this->flushInterval = std::max(flushInterval, 1);
+}
+
+bool Checkpoint::begin(const CheckpointHeader& header, const std::vector<std::vector<double>>& initialVectors, const std::string& rngState) {
+    this->output = std::ofstream(this->path, std::ios::binary | std::ios::trunc);
+    if (!this->output.is_open()) {
+        this->errors << "Error opening checkpoint (" << this->path << ") for writing\n";
+        return false;
+    }
+    this->output.write(MAGIC, sizeof(MAGIC));
+    writeValue(this->output, VERSION);
+    writeValue(this->output, header);
+
+    writeValue(this->output, static_cast<uint32_t>(initialVectors.size()));
+    for (const auto& vec : initialVectors) {
+        writeValue(this->output, static_cast<uint32_t>(vec.size()));
+        this->output.write(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(double));
+    }
+    writeString(this->output, rngState);
+    // the header is worthless if it isn't complete, so always flush it
+    this->output.flush();
+    if (!this->output) {
+        this->errors << "Error writing checkpoint (" << this->path << ")\n";
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint::load(CheckpointState& state) {
+    std::ifstream input(this->path, std::ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    if (!input.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC)) {
+        this->errors << "Checkpoint (" << this->path << ") is not a checkpoint file\n";
+        return false;
+    }
+    if (!readValue(input, version) || version != VERSION) {
+        this->errors << "Checkpoint (" << this->path << ") has unsupported version " << version << "\n";
+        return false;
+    }
+
+    uint32_t vectorCount;
+    if (!readValue(input, state.header) || !readValue(input, vectorCount)) {
+        this->errors << "Checkpoint (" << this->path << ") has a truncated header\n";
+        return false;
+    }
+    // every size below comes from the file, so check it against the header before allocating anything with it
+    const CheckpointHeader& header = state.header;
+    if (header.nodeCount < 0 || header.firstActiveNode < 0 || header.firstActiveNode > header.pastActiveNode ||
+        header.pastActiveNode > header.nodeCount || header.potentialProbeCount < 0 || header.parallelCuts < 1 ||
+        vectorCount != static_cast<uint32_t>(std::max(header.randomVectorCount, 0)) + static_cast<uint32_t>(header.potentialProbeCount)) {
+        this->errors << "Checkpoint (" << this->path << ") has a corrupt header\n";
+        return false;
+    }
+    uint32_t activeNodeCount = static_cast<uint32_t>(header.pastActiveNode - header.firstActiveNode);
+    state.initialVectors.resize(vectorCount);
+    for (auto& vec : state.initialVectors) {
+        uint32_t length;
+        if (!readValue(input, length)) {
+            this->errors << "Checkpoint (" << this->path << ") has a truncated header\n";
+            return false;
+        }
+        if (length != activeNodeCount) {
+            this->errors << "Checkpoint (" << this->path << ") has a corrupt header\n";
+            return false;
+        }
+        vec.resize(length);
+        if (!input.read(reinterpret_cast<char*>(vec.data()), length * sizeof(double))) {
+            this->errors << "Checkpoint (" << this->path << ") has a truncated header\n";
+            return false;
+        }
+    }
+    if (!readString(input, state.rngState)) {
+        this->errors << "Checkpoint (" << this->path << ") has a truncated header\n";
+        return false;
+    }
+
+    state.matchings.clear();
+    std::streamoff validLength = input.tellg();
+
+    // with parallel cuts, every cut of a round is drawn before any of its matchings is recorded, so each record carries the RNG
+    // state from after the whole round. Only whole rounds can be resumed from, and the records of a partly written one are dropped
+    size_t cutsPerRound = static_cast<size_t>(header.parallelCuts);
+
+    // read rounds until the end of the file or the first incomplete record
+    while (true) {
+        uint32_t tag;
+        int32_t round;
+        uint32_t pairCount;
+        if (!readValue(input, tag) || tag != ROUND_TAG || !readValue(input, round) || !readValue(input, pairCount)) {
+            break;
+        }
+        // rounds are always appended in order, and a matching pairs up each node of the smaller side of a cut at most once.
+        // Anything else is a record that was torn or corrupted, so it's dropped like one
+        if (round != static_cast<int32_t>(state.matchings.size()) || pairCount > activeNodeCount / 2) {
+            break;
+        }
+        Matching match(pairCount);
+        if (!input.read(reinterpret_cast<char*>(match.data()), pairCount * sizeof(std::pair<int, int>))) {
+            break;
+        }
+        auto isActive = [&header](int node) {
+            return header.firstActiveNode <= node && node < header.pastActiveNode;
+        };
+        if (!std::all_of(match.begin(), match.end(), [&isActive](const std::pair<int, int>& pair) { return isActive(pair.first) && isActive(pair.second); })) {
+            break;
+        }
+        std::string rngState;
+        if (!readString(input, rngState)) {
+            break;
+        }
+        state.matchings.push_back(std::move(match));
+        if (state.matchings.size() % cutsPerRound == 0) {
+            state.rngState = std::move(rngState);
+            validLength = input.tellg();
+        }
+    }
+    input.close();
+    state.matchings.resize(state.matchings.size() - state.matchings.size() % cutsPerRound);
+
+    // drop any torn record so appends line up with the last complete round
+    std::error_code error;
+    std::filesystem::resize_file(this->path, validLength, error);
+    if (error) {
+        this->errors << "Error truncating checkpoint (" << this->path << "): " << error.message() << "\n";
+        return false;
+    }
+
+    this->output = std::ofstream(this->path, std::ios::binary | std::ios::app);
+    if (!this->output.is_open()) {
+        this->errors << "Error opening checkpoint (" << this->path << ") for writing\n";
+        return false;
+    }
+    return true;
+}
+
+void Checkpoint::appendRound(int round, const Matching& matching, const std::string& rngState) {
+    if (this->writeFailed) {
+        return;
+    }
+    writeValue(this->output, ROUND_TAG);
+    writeValue(this->output, static_cast<int32_t>(round));
+    writeValue(this->output, static_cast<uint32_t>(matching.size()));
+    this->output.write(reinterpret_cast<const char*>(matching.data()), matching.size() * sizeof(std::pair<int, int>));
+    writeString(this->output, rngState);
+
+    this->unflushedRounds++;
+    if (this->unflushedRounds >= this->flushInterval) {
+        this->flush();
+    }
+    this->checkWritten();
+}
+
+void Checkpoint::flush() {
+    if (this->writeFailed) {
+        return;
+    }
+    this->output.flush();
+    this->unflushedRounds = 0;
+    this->checkWritten();
+}
+
+void Checkpoint::checkWritten() {
+    if (!this->writeFailed && !this->output) {
+        // the rounds before this one are still on disk, and a torn record after them is dropped when loading
+        this->errors << "Error writing checkpoint (" << this->path << "). Not checkpointing any further rounds\n";
+        this->writeFailed = true;
+    }
+}
@@ -0,0 +1,73 @@
+//
+//  Checkpoint.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Binary, append-only checkpoint of a running game.
+// The header is written once (options, graph fingerprint, the random vectors before any matching was applied and the RNG state),
+// after that every round only appends its matching and the RNG state, so writing a checkpoint costs O(n) per round.
+// The cached vectors are not stored per round, they're rebuilt on resume by replaying the matchings onto the initial vectors.
+
+#ifndef Checkpoint_hpp
+#define Checkpoint_hpp
+
+#include "Graph.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct CheckpointHeader {
+    uint64_t graphFingerprint;
+    int32_t nodeCount;
+    int32_t firstActiveNode;
+    int32_t pastActiveNode;
+    int32_t phiInverse;
+    int32_t randomVectorCount;
+    int32_t potentialProbeCount;
+    // a VectorPrecision
+    int32_t vectorPrecision;
+    // a CutPlayer
+    int32_t cutPlayer;
+    int32_t parallelCuts;
+    // 1 if the max flows were warm started, which can change the flow they find and so the matchings
+    int32_t warmStart;
+};
+
+struct CheckpointState {
+    CheckpointHeader header;
+    // random vectors as they were generated, before any matching was applied (the cache, then the potential probes)
+    std::vector<std::vector<double>> initialVectors;
+    std::vector<Matching> matchings;
+    // RNG state (in the text form std::mt19937 streams to) after the last restored round
+    std::string rngState;
+};
+
+class Checkpoint {
+public:
+    // problems reading or writing the file are reported to errors
+    Checkpoint(std::string path, std::ostream& errors);
+    // flushes the file every flushInterval rounds, since a record is only useful once it hits the disk
+    void setFlushInterval(int flushInterval);
+    // starts a new checkpoint, throwing away anything previously at path
+    bool begin(const CheckpointHeader& header, const std::vector<std::vector<double>>& initialVectors, const std::string& rngState);
+    // reads every complete round in the checkpoint. A torn record at the end (crash mid-write) is dropped, along with the rest of its
+    // round when the header has parallelCuts > 1, and the file is truncated so following appends continue right after the last
+    // complete round. Returns false if there's no usable checkpoint
+    bool load(CheckpointState& state);
+    void appendRound(int round, const Matching& matching, const std::string& rngState);
+    void flush();
+private:
+    std::string path;
+    std::ostream& errors;
+    std::ofstream output;
+    int flushInterval = 1;
+    int unflushedRounds = 0;
+    // set once a write fails, after which nothing more is written
+    bool writeFailed = false;
+    // reports a failed write the first time it happens
+    void checkWritten();
+};
+
+#endif /* Checkpoint_hpp */
@@ -0,0 +1,143 @@
+//
+//  CommandLine.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "CommandLine.hpp"
+#include <cstdlib>
+
+void printUsage(std::ostream& errors) {
+    errors << "Expected 2 or 3  arguments: 1/phi, file, and #random_vectors (OPTIONAL)\n";
+    errors << "Flags: --checkpoint file, --checkpoint-every #rounds, --resume, --early-stop, --potential-probes #probes, --pipelined, --certificate file, --memory-profile, --seed seed, --phi-search maxPhiInverse, --witness file, --order input|bfs|rcm|degree, --precision double|float|fixed, --precision-check, --no-screen, --cut-player krv|multi|power, --warm-start, --parallel-cuts #cuts\n";
+}
+
+std::optional<Invocation> parseInvocation(const std::vector<std::string>& args, std::ostream& errors) {
+    Invocation invocation;
+    GameOptions& options = invocation.options;
+    bool resume = false;
+    // positional arguments are 1/phi, file, and #random_vectors, everything starting with -- is a flag
+    std::vector<std::string> positional;
+    for (size_t index = 0; index < args.size(); index++) {
+        const std::string& arg = args[index];
+        bool hasValue = index + 1 < args.size();
+        if (arg == "--resume") {
+            resume = true;
+        } else if (arg == "--checkpoint" && hasValue) {
+            options.checkpointPath = args[++index];
+        } else if (arg == "--checkpoint-every" && hasValue) {
+            options.checkpointInterval = atoi(args[++index].c_str());
+        } else if (arg == "--parallel-cuts" && hasValue) {
+            options.parallelCuts = atoi(args[++index].c_str());
+        } else if (arg == "--warm-start") {
+            options.warmStart = true;
+        } else if (arg == "--no-screen") {
+            options.screen = false;
+        } else if (arg == "--early-stop") {
+            options.earlyStop = true;
+        } else if (arg == "--potential-probes" && hasValue) {
+            options.potentialProbeCount = atoi(args[++index].c_str());
+        } else if (arg == "--pipelined") {
+            options.pipelined = true;
+        } else if (arg == "--certificate" && hasValue) {
+            options.certificatePath = args[++index];
+        } else if (arg == "--memory-profile") {
+            options.memoryProfile = true;
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<uint32_t>(strtoul(args[++index].c_str(), nullptr, 10));
+        } else if (arg == "--phi-search" && hasValue) {
+            invocation.phiSearchLimit = atoi(args[++index].c_str());
+        } else if (arg == "--witness" && hasValue) {
+            invocation.witnessPath = args[++index];
+        } else if (arg == "--precision" && hasValue) {
+            std::optional<VectorPrecision> precision = parseVectorPrecision(args[++index]);
+            if (!precision) {
+                errors << "Unknown vector precision " << args[index] << ", expected double, float or fixed\n";
+                return std::nullopt;
+            }
+            options.vectorPrecision = *precision;
+        } else if (arg == "--precision-check") {
+            options.precisionCheck = true;
+        } else if (arg == "--cut-player" && hasValue) {
+            std::optional<CutPlayer> player = parseCutPlayer(args[++index]);
+            if (!player) {
+                errors << "Unknown cut player " << args[index] << ", expected krv, multi or power\n";
+                return std::nullopt;
+            }
+            options.cutPlayer = *player;
+        } else if (arg == "--order" && hasValue) {
+            std::optional<VertexOrdering> ordering = parseVertexOrdering(args[++index]);
+            if (!ordering) {
+                errors << "Unknown vertex order " << args[index] << ", expected input, bfs, rcm or degree\n";
+                return std::nullopt;
+            }
+            invocation.ordering = *ordering;
+        } else if (arg.starts_with("--")) {
+            errors << "Unknown or incomplete flag " << arg << "\n";
+            return std::nullopt;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    
+    if (positional.size() != 2 && positional.size() != 3) {
+        printUsage(errors);
+        return std::nullopt;
+    }
+    
+    options.phiInverse = atoi(positional[0].c_str());
+    invocation.inputPath = positional[1];
+    
+    // use -1 as an value for infinite if not present
+    if (positional.size() == 3) {
+        options.randomVectorCount = atoi(positional[2].c_str());
+    }
+    
+    if (resume) {
+        // default to a checkpoint next to the graph so --resume works on its own
+        if (options.checkpointPath.empty()) {
+            options.checkpointPath = invocation.inputPath + ".ckpt";
+        }
+        options.resume = true;
+    }
+    if (invocation.phiSearchLimit != 0 && !options.checkpointPath.empty()) {
+        // every probe is its own game, and they can't share one checkpoint
+        errors << "--phi-search can't be combined with checkpoints\n";
+        return std::nullopt;
+    }
+    if (invocation.phiSearchLimit != 0 && invocation.phiSearchLimit < options.phiInverse) {
+        errors << "--phi-search limit " << invocation.phiSearchLimit << " is below the starting phiInverse " << options.phiInverse << "\n";
+        return std::nullopt;
+    }
+    if (options.potentialProbeCount < 1) {
+        // the potential is averaged over the probes
+        errors << "--potential-probes has to be at least 1\n";
+        return std::nullopt;
+    }
+    if (options.parallelCuts < 1) {
+        errors << "--parallel-cuts has to be at least 1\n";
+        return std::nullopt;
+    }
+    if (options.randomVectorCount != -1 && options.randomVectorCount < options.parallelCuts) {
+        // each of a round's cuts takes the next cached vector, so a smaller cache would play some cut twice in the same round
+        errors << "--parallel-cuts " << options.parallelCuts << " needs at least as many #random_vectors\n";
+        return std::nullopt;
+    }
+    if (options.parallelCuts > 1 && options.pipelined) {
+        // pipelining overlaps one round's flow with the next round's projection, parallel cuts run several flows instead
+        errors << "--parallel-cuts can't be combined with --pipelined\n";
+        return std::nullopt;
+    }
+    if (options.precisionCheck && options.vectorPrecision == VectorPrecision::Double) {
+        // the check compares the reduced precision vectors against exact ones, and double ones are the exact ones
+        errors << "--precision-check needs --precision float or fixed\n";
+        return std::nullopt;
+    }
+    if (options.cutPlayer != CutPlayer::KRV && (options.pipelined || options.randomVectorCount != -1 || options.vectorPrecision != VectorPrecision::Double || options.precisionCheck)) {
+        // the other cut players project fresh double vectors every round, so there's no single projection to prepare ahead or cache
+        errors << "--cut-player " << cutPlayerName(options.cutPlayer) << " can't be combined with --pipelined, #random_vectors or --precision\n";
+        return std::nullopt;
+    }
+    return invocation;
+}
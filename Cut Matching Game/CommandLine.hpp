@@ -0,0 +1,33 @@
+//
+//  CommandLine.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Parsing for a game's arguments (`1/phi file [#random_vectors] [flags]`), shared by the command line and the daemon's requests.
+
+#ifndef CommandLine_hpp
+#define CommandLine_hpp
+
+#include "Game.hpp"
+#include "Reordering.hpp"
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct Invocation {
+    GameOptions options;
+    std::string inputPath;
+    // if set, search phiInverse from options.phiInverse up to this instead of playing one game
+    int phiSearchLimit = 0;
+    // where the search writes its sparsest cut witness
+    std::string witnessPath;
+    VertexOrdering ordering = VertexOrdering::Input;
+};
+
+// returns nothing (after saying what's wrong on errors) if the arguments don't describe a game
+std::optional<Invocation> parseInvocation(const std::vector<std::string>& args, std::ostream& errors);
+void printUsage(std::ostream& errors);
+
+#endif /* CommandLine_hpp */
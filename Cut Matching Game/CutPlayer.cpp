@@ -0,0 +1,62 @@
+//
+//  CutPlayer.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "CutPlayer.hpp"
+#include <cmath>
+#include <iterator>
+#include <numeric>
+
+namespace {
+
+const char* NAMES[] = {"krv", "multi", "power"};
+// power iteration steps on the projections' covariance. It's tiny, so this is plenty
+const int PRINCIPAL_DIRECTION_STEPS = 50;
+
+}
+
+std::optional<CutPlayer> parseCutPlayer(const std::string& name) {
+    for (int player = 0; player < static_cast<int>(std::size(NAMES)); player++) {
+        if (name == NAMES[player]) {
+            return static_cast<CutPlayer>(player);
+        }
+    }
+    return std::nullopt;
+}
+
+const char* cutPlayerName(CutPlayer player) {
+    return NAMES[static_cast<int>(player)];
+}
+
+std::vector<double> principalDirection(const std::vector<std::vector<double>>& projections) {
+    int count = static_cast<int>(projections.size());
+    // covariance of the projections, only count x count so power iteration on it is free
+    std::vector<std::vector<double>> covariance(count, std::vector<double>(count, 0));
+    for (int row = 0; row < count; row++) {
+        for (int column = row; column < count; column++) {
+            double sum = std::inner_product(projections[row].begin(), projections[row].end(), projections[column].begin(), 0.0);
+            covariance[row][column] = sum;
+            covariance[column][row] = sum;
+        }
+    }
+    std::vector<double> direction(count, 1 / std::sqrt(static_cast<double>(count)));
+    std::vector<double> next(count);
+    for (int step = 0; step < PRINCIPAL_DIRECTION_STEPS; step++) {
+        double length = 0;
+        for (int row = 0; row < count; row++) {
+            next[row] = std::inner_product(covariance[row].begin(), covariance[row].end(), direction.begin(), 0.0);
+            length += next[row] * next[row];
+        }
+        if (length == 0) {
+            break;
+        }
+        length = std::sqrt(length);
+        for (int row = 0; row < count; row++) {
+            direction[row] = next[row] / length;
+        }
+    }
+    return direction;
+}
@@ -0,0 +1,41 @@
+//
+//  CutPlayer.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Cut players other than KRV's, which split a single projected random vector at its median.
+// Both alternatives look harder for a direction the matchings' random walk has mixed slowly in (in the style of the OSVV/KKOV cut
+// players) before splitting at the median, so each round's matching goes straight at what's keeping the walk from mixing.
+// That costs a few more passes over the matchings per round, but those are cheap next to a max flow.
+
+#ifndef CutPlayer_hpp
+#define CutPlayer_hpp
+
+#include "Graph.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class CutPlayer {
+    // split one projected random vector at the median
+    KRV,
+    // project several random vectors, and split along their principal direction
+    Multi,
+    // a few steps of power iteration on the matching walk to find its slowest mixing direction, and split along that
+    Power,
+};
+
+std::optional<CutPlayer> parseCutPlayer(const std::string& name);
+const char* cutPlayerName(CutPlayer player);
+
+// how many vectors the multi player projects every round
+const int MULTI_PLAYER_VECTORS = 4;
+// how many times the power player goes through the matchings and back before projecting
+const int POWER_PLAYER_STEPS = 3;
+
+// the unit vector (over the projections) the projections vary the most along, i.e. the top principal component. Every projection has
+// to be centered
+std::vector<double> principalDirection(const std::vector<std::vector<double>>& projections);
+
+#endif /* CutPlayer_hpp */
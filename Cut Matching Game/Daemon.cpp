@@ -0,0 +1,366 @@
+//
+//  Daemon.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "Daemon.hpp"
+#include "CommandLine.hpp"
+#include "Game.hpp"
+#include "MemoryProfile.hpp"
+#include "PhiSearch.hpp"
+#include "ThreadPool.hpp"
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <poll.h>
+#include <streambuf>
+#include <unistd.h>
+
+const char* const STATUS_DONE = "DONE";
+const char* const STATUS_FAILED = "FAILED";
+
+namespace {
+
+// requests are a line of arguments, anything longer than this isn't one
+const size_t MAX_REQUEST_LENGTH = 1 << 16;
+// a client that hasn't sent its request by then is dropped, so idle connections can't hold on to the workers
+const int REQUEST_TIMEOUT_SECONDS = 10;
+
+// written to by the signal handler to wake up the accept loop
+int stopPipe[2] = {-1, -1};
+
+void requestStop(int) {
+    char byte = 0;
+    // nothing useful to do if this fails, the pipe is already full of stop requests
+    [[maybe_unused]] ssize_t written = write(stopPipe[1], &byte, 1);
+}
+
+bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+// buffers output for a socket, sending it whenever a line is finished so progress shows up as it happens.
+// Once the client goes away writes fail quietly and the game plays out
+class SocketBuffer : public std::streambuf {
+public:
+    explicit SocketBuffer(int fd) : fd(fd) {
+        this->setp(this->buffer, this->buffer + sizeof(this->buffer));
+    }
+    ~SocketBuffer() override {
+        this->sync();
+    }
+protected:
+    int_type overflow(int_type character) override {
+        if (this->sync() == -1) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(character, traits_type::eof())) {
+            *this->pptr() = traits_type::to_char_type(character);
+            this->pbump(1);
+        }
+        return traits_type::not_eof(character);
+    }
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        std::streamsize put = std::streambuf::xsputn(data, count);
+        if (std::memchr(data, '\n', count) != nullptr) {
+            this->sync();
+        }
+        return put;
+    }
+    int sync() override {
+        bool sent = writeAll(this->fd, this->pbase(), this->pptr() - this->pbase());
+        this->setp(this->buffer, this->buffer + sizeof(this->buffer));
+        return sent ? 0 : -1;
+    }
+private:
+    int fd;
+    char buffer[4096];
+};
+
+std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t end = line.find('\t', start);
+        fields.push_back(line.substr(start, end - start));
+        if (end == std::string::npos) {
+            return fields;
+        }
+        start = end + 1;
+    }
+}
+
+// reads up to the first newline. Returns nothing if the client hangs up first, sends too much, or hasn't sent all of it within
+// REQUEST_TIMEOUT_SECONDS
+std::optional<std::string> readRequest(int connection) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(REQUEST_TIMEOUT_SECONDS);
+    std::string request;
+    char chunk[4096];
+    while (request.size() < MAX_REQUEST_LENGTH) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        pollfd watched = {connection, POLLIN, 0};
+        int ready = remaining.count() > 0 ? poll(&watched, 1, static_cast<int>(remaining.count())) : 0;
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            return std::nullopt;
+        }
+        ssize_t count = read(connection, chunk, sizeof(chunk));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return std::nullopt;
+        }
+        request.append(chunk, count);
+        size_t end = request.find('\n');
+        if (end != std::string::npos) {
+            request.resize(end);
+            return request;
+        }
+    }
+    return std::nullopt;
+}
+
+void resolvePath(std::string& path, const std::filesystem::path& directory) {
+    if (!path.empty() && std::filesystem::path(path).is_relative()) {
+        path = (directory / path).string();
+    }
+}
+
+// closes the connection whichever way its request ends
+class ConnectionGuard {
+public:
+    explicit ConnectionGuard(int fd) : fd(fd) { }
+    ~ConnectionGuard() {
+        close(this->fd);
+    }
+    ConnectionGuard(const ConnectionGuard&) = delete;
+    ConnectionGuard& operator=(const ConnectionGuard&) = delete;
+private:
+    int fd;
+};
+
+bool fillAddress(const std::string& socketPath, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path (" << socketPath << ") is too long\n";
+        return false;
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    return true;
+}
+
+}
+
+Daemon::Daemon(const DaemonOptions& options) : options(options), cache(options.graphCacheSize) { }
+
+bool Daemon::serve() {
+    sockaddr_un address;
+    if (!fillAddress(this->options.socketPath, address)) {
+        return false;
+    }
+    // a socket left behind by a daemon that didn't shut down cleanly would make bind fail. Don't remove anything else though
+    struct stat existing;
+    if (stat(this->options.socketPath.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+        unlink(this->options.socketPath.c_str());
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+        std::cerr << "Error listening on " << this->options.socketPath << ": " << strerror(errno) << "\n";
+        if (listener >= 0) {
+            close(listener);
+        }
+        return false;
+    }
+
+    // clients that hang up mid-game shouldn't take the daemon down with them
+    signal(SIGPIPE, SIG_IGN);
+    if (pipe(stopPipe) != 0) {
+        std::cerr << "Error creating stop pipe: " << strerror(errno) << "\n";
+        close(listener);
+        return false;
+    }
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+
+    {
+        ThreadPool pool(this->options.workers);
+        std::cout << "Listening on " << this->options.socketPath << " with " << pool.threadCount() << " workers" << std::endl;
+        pollfd watched[2] = {{listener, POLLIN, 0}, {stopPipe[0], POLLIN, 0}};
+        while (true) {
+            if (poll(watched, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "Error waiting for connections: " << strerror(errno) << "\n";
+                break;
+            }
+            if (watched[1].revents != 0) {
+                break;
+            }
+            int connection = accept(listener, nullptr, nullptr);
+            if (connection < 0) {
+                continue;
+            }
+            pool.submit([this, connection] {
+                ConnectionGuard guard(connection);
+                this->handle(connection);
+            });
+        }
+        std::cout << "Stopping. Finishing the games already accepted" << std::endl;
+        close(listener);
+        unlink(this->options.socketPath.c_str());
+    }
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+    return true;
+}
+
+void Daemon::handle(int connection) {
+    SocketBuffer buffer(connection);
+    std::ostream out(&buffer);
+    try {
+        this->play(connection, out);
+    } catch (const std::exception& error) {
+        out << "Error: " << error.what() << "\n" << STATUS_FAILED << "\n";
+    } catch (...) {
+        out << "Error: unknown exception\n" << STATUS_FAILED << "\n";
+    }
+}
+
+void Daemon::play(int connection, std::ostream& out) {
+    std::optional<std::string> request = readRequest(connection);
+    if (!request) {
+        out << "Expected a line of tab separated arguments within " << REQUEST_TIMEOUT_SECONDS << " seconds\n" << STATUS_FAILED << "\n";
+        return;
+    }
+    std::vector<std::string> fields = splitFields(*request);
+    std::filesystem::path directory = fields[0];
+    std::optional<Invocation> invocation = parseInvocation(std::vector<std::string>(fields.begin() + 1, fields.end()), out);
+    if (!invocation) {
+        out << STATUS_FAILED << "\n";
+        return;
+    }
+    GameOptions& options = invocation->options;
+    resolvePath(invocation->inputPath, directory);
+    resolvePath(options.checkpointPath, directory);
+    resolvePath(options.certificatePath, directory);
+    options.output = &out;
+    options.errors = &out;
+
+    bool hit = false;
+    std::shared_ptr<const LoadedGraph> loaded = this->cache.get(invocation->inputPath, invocation->ordering, out, hit);
+    if (!loaded) {
+        out << "Couldn't load graph " << invocation->inputPath << "\n" << STATUS_FAILED << "\n";
+        return;
+    }
+    out << (hit ? "Using cached graph " : "Loaded graph ") << invocation->inputPath << "\n";
+    const Graph& graph = loaded->graph;
+    if (loaded->order) {
+        options.vertexOrder = &*loaded->order;
+    }
+
+    std::string status = STATUS_FAILED;
+    if (invocation->phiSearchLimit != 0) {
+        resolvePath(invocation->witnessPath, directory);
+        PhiSearch search(graph, options, invocation->phiSearchLimit, invocation->witnessPath);
+        if (std::optional<PhiSearchResult> result = search.run()) {
+            status = std::string(STATUS_DONE) + " search " + std::to_string(result->cutPhiInverse) + " " + std::to_string(result->expanderPhiInverse);
+        }
+    } else {
+        Game game(graph, 0, graph.nodeCount(), options);
+        if (std::optional<GameResult> result = game.run()) {
+            status = std::string(STATUS_DONE) + (result->foundCut ? " cut " : " expander ") + std::to_string(result->rounds);
+        }
+    }
+    if (options.memoryProfile) {
+        // the counters are for the whole daemon, so they include any other games running alongside this one
+        MemoryProfile::reportSummary(out);
+    }
+    out << status << "\n";
+}
+
+int runClient(const std::string& socketPath, const std::vector<std::string>& args) {
+    std::string request = std::filesystem::current_path().string();
+    for (const std::string& arg : args) {
+        if (arg.find_first_of("\t\n") != std::string::npos) {
+            std::cerr << "Arguments sent to the daemon can't contain tabs or newlines\n";
+            return EXIT_FAILURE;
+        }
+        request += "\t" + arg;
+    }
+    request += "\n";
+
+    sockaddr_un address;
+    if (!fillAddress(socketPath, address)) {
+        return EXIT_FAILURE;
+    }
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0 || connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Error connecting to " << socketPath << ": " << strerror(errno) << "\n";
+        if (connection >= 0) {
+            close(connection);
+        }
+        return EXIT_FAILURE;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    if (!writeAll(connection, request.data(), request.size())) {
+        std::cerr << "Error sending request: " << strerror(errno) << "\n";
+        close(connection);
+        return EXIT_FAILURE;
+    }
+
+    // print everything but the status line, which decides the exit code
+    int exitCode = EXIT_FAILURE;
+    std::string pending;
+    char chunk[4096];
+    ssize_t count;
+    while ((count = read(connection, chunk, sizeof(chunk))) != 0) {
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error reading from daemon: " << strerror(errno) << "\n";
+            break;
+        }
+        pending.append(chunk, count);
+        size_t start = 0;
+        size_t end;
+        while ((end = pending.find('\n', start)) != std::string::npos) {
+            std::string line = pending.substr(start, end - start);
+            if (line.starts_with(STATUS_DONE)) {
+                exitCode = EXIT_SUCCESS;
+            } else if (line != STATUS_FAILED) {
+                std::cout << line << "\n";
+            }
+            start = end + 1;
+        }
+        std::cout.flush();
+        pending.erase(0, start);
+    }
+    close(connection);
+    return exitCode;
+}
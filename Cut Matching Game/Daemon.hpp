@@ -0,0 +1,49 @@
+//
+//  Daemon.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Serves games over a Unix domain socket, so many queries against the same few graphs don't each pay for starting up and parsing.
+// A connection carries one request: a single line of tab separated fields, the first being the working directory relative paths
+// are resolved against and the rest being the same arguments cmg takes. The game's output is streamed back line by line as it's
+// played, followed by a status line (see STATUS_DONE / STATUS_FAILED), and then the connection is closed.
+
+#ifndef Daemon_hpp
+#define Daemon_hpp
+
+#include "GraphCache.hpp"
+#include <string>
+#include <vector>
+
+struct DaemonOptions {
+    std::string socketPath;
+    // games played at once, 0 for one per core
+    int workers = 0;
+    // how many parsed graphs to keep around
+    int graphCacheSize = 8;
+};
+
+// the last line of a response is either "DONE cut #rounds", "DONE expander #rounds", "FAILED", or for --phi-search
+// "DONE search cutPhiInverse expanderPhiInverse" (0 where the search found none)
+extern const char* const STATUS_DONE;
+extern const char* const STATUS_FAILED;
+
+class Daemon {
+public:
+    explicit Daemon(const DaemonOptions& options);
+    // listens on the socket and serves requests until SIGINT or SIGTERM, then finishes the games already accepted.
+    // Returns false if the socket couldn't be set up
+    bool serve();
+private:
+    const DaemonOptions options;
+    GraphCache cache;
+    // answers the request on connection, reporting anything that goes wrong (even a throw) to the client
+    void handle(int connection);
+    void play(int connection, std::ostream& out);
+};
+
+// sends args to the daemon listening at socketPath and prints what it streams back. Returns the exit code for cmg
+int runClient(const std::string& socketPath, const std::vector<std::string>& args);
+
+#endif /* Daemon_hpp */
@@ -7,6 +7,8 @@
 
 #include "EdmondsKarpMaxFlow.hpp"
 #include <cassert>
+#include <limits>
+#include <queue>
 #include <unordered_map>
 
 EdmondsKarpMaxFlow::EdmondsKarpMaxFlow(const Graph& graph, int source, int sink, int targetFlow, int phiInverse) : MaxFlow(graph, source, sink, targetFlow, phiInverse) {
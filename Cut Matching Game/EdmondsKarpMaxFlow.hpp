@@ -9,6 +9,7 @@
 #define EdmondsKarpMaxFlow_hpp
 
 #include "MaxFlow.hpp"
+#include <unordered_map>
 
 class EdmondsKarpMaxFlow : public MaxFlow {
 public:
@@ -0,0 +1,352 @@
+//
+//  FlowKernel.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "FlowKernel.hpp"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace {
+
+// parentArc of a node reached straight from the source
+const uint32_t FROM_SOURCE = std::numeric_limits<uint32_t>::max();
+
+}
+
+FlowLayout::FlowLayout(const Graph& graph) : nodeCount(graph.nodeCount()) {
+    this->arcOffsets.resize(this->nodeCount + 1, 0);
+    for (int node = 0; node < this->nodeCount; node++) {
+        this->arcOffsets[node + 1] = this->arcOffsets[node] + static_cast<uint32_t>(graph.neighbors(node).size());
+    }
+    uint32_t arcCount = this->arcOffsets.back();
+    this->arcHeads.resize(arcCount);
+    this->reverseArcs.resize(arcCount);
+    for (int node = 0; node < this->nodeCount; node++) {
+        const auto& neighbors = graph.neighbors(node);
+        for (size_t arc = 0; arc < neighbors.size(); arc++) {
+            this->arcHeads[this->arcOffsets[node] + arc] = neighbors[arc].to_vertex;
+        }
+    }
+
+    // pair every arc u -> v with an arc v -> u. Arcs up to higher nodes are handed out row by row, so the arcs waiting for each node
+    // are sorted by their tail, and line up with that node's arcs back to lower nodes once those are sorted too (like the certificate
+    // numbers edges). Graph::load turns away graphs where they wouldn't, see Graph::isSymmetric
+    std::vector<std::vector<uint32_t>> waitingArcs(this->nodeCount);
+    std::vector<uint32_t> lowerArcs;
+    for (int node = 0; node < this->nodeCount; node++) {
+        lowerArcs.clear();
+        for (uint32_t arc = this->arcOffsets[node]; arc < this->arcOffsets[node + 1]; arc++) {
+            int head = this->arcHeads[arc];
+            if (head > node) {
+                waitingArcs[head].push_back(arc);
+            } else if (head < node) {
+                lowerArcs.push_back(arc);
+            } else {
+                // a self loop never carries flow, pushing along it just pushes back
+                this->reverseArcs[arc] = arc;
+            }
+        }
+        std::stable_sort(lowerArcs.begin(), lowerArcs.end(), [this](uint32_t left, uint32_t right) {
+            return this->arcHeads[left] < this->arcHeads[right];
+        });
+        assert(lowerArcs.size() == waitingArcs[node].size());
+        for (size_t index = 0; index < lowerArcs.size(); index++) {
+            this->reverseArcs[lowerArcs[index]] = waitingArcs[node][index];
+            this->reverseArcs[waitingArcs[node][index]] = lowerArcs[index];
+        }
+        std::vector<uint32_t>().swap(waitingArcs[node]);
+    }
+}
+
+std::unique_ptr<FlowKernel> FlowKernel::create(std::shared_ptr<const FlowLayout> layout, int phiInverse, bool warmStart) {
+    // a reverse arc holds its own capacity plus whatever flows the other way
+    int64_t largestResidual = 2 * static_cast<int64_t>(phiInverse);
+    if (phiInverse == 1) {
+        return std::make_unique<CSRFlowKernel<uint8_t, CapacityMode::Unit>>(std::move(layout), phiInverse, warmStart);
+    }
+    if (largestResidual <= std::numeric_limits<uint8_t>::max()) {
+        return std::make_unique<CSRFlowKernel<uint8_t, CapacityMode::PhiScaled>>(std::move(layout), phiInverse, warmStart);
+    }
+    if (largestResidual <= std::numeric_limits<uint16_t>::max()) {
+        return std::make_unique<CSRFlowKernel<uint16_t, CapacityMode::PhiScaled>>(std::move(layout), phiInverse, warmStart);
+    }
+    return std::make_unique<CSRFlowKernel<int32_t, CapacityMode::PhiScaled>>(std::move(layout), phiInverse, warmStart);
+}
+
+template <typename Residual, CapacityMode Mode>
+CSRFlowKernel<Residual, Mode>::CSRFlowKernel(std::shared_ptr<const FlowLayout> layout, int phiInverse, bool warmStart) : layout(std::move(layout)), nodeCount(this->layout->nodeCount), phiInverse(phiInverse), warmStart(warmStart), arcOffsets(this->layout->arcOffsets), arcHeads(this->layout->arcHeads), reverseArcs(this->layout->reverseArcs) {
+    uint32_t arcCount = this->arcOffsets.back();
+    this->residual.resize(arcCount);
+    this->side.resize(this->nodeCount);
+    this->terminalResidual.resize(this->nodeCount);
+    this->visitStamp.resize(this->nodeCount, 0);
+    this->parentArc.resize(this->nodeCount);
+    this->queue.reserve(this->nodeCount);
+    if (warmStart) {
+        this->sinkCursor.resize(this->nodeCount);
+    }
+}
+
+template <typename Residual, CapacityMode Mode>
+const char* CSRFlowKernel<Residual, Mode>::name() const {
+    if constexpr (Mode == CapacityMode::Unit) {
+        return "unit/uint8";
+    } else if constexpr (std::is_same_v<Residual, uint8_t>) {
+        return "phi/uint8";
+    } else if constexpr (std::is_same_v<Residual, uint16_t>) {
+        return "phi/uint16";
+    } else {
+        return "phi/int32";
+    }
+}
+
+template <typename Residual, CapacityMode Mode>
+Residual CSRFlowKernel<Residual, Mode>::capacity() const {
+    if constexpr (Mode == CapacityMode::Unit) {
+        return 1;
+    } else {
+        return static_cast<Residual>(this->phiInverse);
+    }
+}
+
+template <typename Residual, CapacityMode Mode>
+int CSRFlowKernel<Residual, Mode>::computeMaxFlow(const Cut& cut) {
+    std::fill(this->residual.begin(), this->residual.end(), this->capacity());
+    std::fill(this->side.begin(), this->side.end(), None);
+    std::fill(this->terminalResidual.begin(), this->terminalResidual.end(), 0);
+    // the source's arcs are visited in node order
+    this->sourceSide = cut.first;
+    std::sort(this->sourceSide.begin(), this->sourceSide.end());
+    for (int node : this->sourceSide) {
+        this->side[node] = SourceSide;
+        this->terminalResidual[node] = 1;
+    }
+    for (int node : cut.second) {
+        this->side[node] = SinkSide;
+        this->terminalResidual[node] = 1;
+    }
+    this->pairs.clear();
+
+    int flow = this->warmStart ? this->routeShortPaths() : 0;
+    this->lastWarmStartedFlow = flow;
+    int last;
+    while ((last = this->findPath()) != -1) {
+        // every path carries one unit, since that's all a terminal arc holds
+        this->terminalResidual[last] = 0;
+        int node = last;
+        while (this->parentArc[node] != FROM_SOURCE) {
+            uint32_t arc = this->parentArc[node];
+            uint32_t reverse = this->reverseArcs[arc];
+            this->residual[arc]--;
+            this->residual[reverse]++;
+            node = this->arcHeads[reverse];
+        }
+        this->terminalResidual[node] = 0;
+        this->pairs.push_back({last, node});
+        flow++;
+    }
+    return flow;
+}
+
+template <typename Residual, CapacityMode Mode>
+void CSRFlowKernel<Residual, Mode>::routeUnit(int from, int to, std::initializer_list<uint32_t> arcs) {
+    for (uint32_t arc : arcs) {
+        this->residual[arc]--;
+        this->residual[this->reverseArcs[arc]]++;
+    }
+    this->terminalResidual[from] = 0;
+    this->terminalResidual[to] = 0;
+    this->pairs.push_back({to, from});
+}
+
+template <typename Residual, CapacityMode Mode>
+int CSRFlowKernel<Residual, Mode>::routeShortPaths() {
+    auto openSink = [this](int node) {
+        return this->side[node] == SinkSide && this->terminalResidual[node] > 0;
+    };
+    int routed = 0;
+    for (int node : this->sourceSide) {
+        for (uint32_t arc = this->arcOffsets[node]; arc < this->arcOffsets[node + 1]; arc++) {
+            if (this->residual[arc] > 0 && openSink(this->arcHeads[arc])) {
+                this->routeUnit(node, this->arcHeads[arc], {arc});
+                routed++;
+                break;
+            }
+        }
+    }
+
+    // Each relay's cursor only moves forward, which keeps the two hop pass linear. Open sinks only close, and an arc only gets
+    // residual back when a route uses its reverse. That happens to an arc out of a relay when a route ends at the relay through it,
+    // which only sink side relays can be, so a sink side relay's cursor can have passed an arc that's useful again. The warm start
+    // just misses that two hop route, and the max flow finds it
+    std::copy(this->arcOffsets.begin(), this->arcOffsets.end() - 1, this->sinkCursor.begin());
+    for (int node : this->sourceSide) {
+        if (this->terminalResidual[node] == 0) {
+            continue;
+        }
+        for (uint32_t arc = this->arcOffsets[node]; arc < this->arcOffsets[node + 1]; arc++) {
+            int middle = this->arcHeads[arc];
+            if (this->residual[arc] == 0 || middle == node) {
+                continue;
+            }
+            uint32_t& cursor = this->sinkCursor[middle];
+            uint32_t end = this->arcOffsets[middle + 1];
+            while (cursor < end && (this->residual[cursor] == 0 || !openSink(this->arcHeads[cursor]))) {
+                cursor++;
+            }
+            if (cursor < end) {
+                this->routeUnit(node, this->arcHeads[cursor], {arc, cursor});
+                routed++;
+                break;
+            }
+        }
+    }
+    return routed;
+}
+
+template <typename Residual, CapacityMode Mode>
+int CSRFlowKernel<Residual, Mode>::findPath() {
+    if (++this->stamp == 0) {
+        // wrapped around, so old stamps could look current
+        std::fill(this->visitStamp.begin(), this->visitStamp.end(), 0);
+        this->stamp = 1;
+    }
+    this->queue.clear();
+    for (int node : this->sourceSide) {
+        if (this->terminalResidual[node] > 0) {
+            this->visitStamp[node] = this->stamp;
+            this->parentArc[node] = FROM_SOURCE;
+            this->queue.push_back(node);
+        }
+    }
+    for (size_t head = 0; head < this->queue.size(); head++) {
+        int node = this->queue[head];
+        for (uint32_t arc = this->arcOffsets[node]; arc < this->arcOffsets[node + 1]; arc++) {
+            int next = this->arcHeads[arc];
+            if (this->residual[arc] > 0 && this->visitStamp[next] != this->stamp) {
+                this->visitStamp[next] = this->stamp;
+                this->parentArc[next] = arc;
+                this->queue.push_back(next);
+            }
+        }
+        // the sink arc comes after the inner arcs, like the edge addSourceSink appends
+        if (this->side[node] == SinkSide && this->terminalResidual[node] > 0) {
+            return node;
+        }
+    }
+    return -1;
+}
+
+template <typename Residual, CapacityMode Mode>
+Matching CSRFlowKernel<Residual, Mode>::matching() const {
+    return this->pairs;
+}
+
+template <typename Residual, CapacityMode Mode>
+void CSRFlowKernel<Residual, Mode>::decomposeFlowPaths(const std::function<void(int, int, const std::vector<std::pair<int, int>>&)>& onPath) const {
+    // flow left to assign on every arc. Both directions of an edge start with the same capacity, so whatever the residual is
+    // missing is flow going that way
+    std::vector<Residual> remaining(this->residual.size());
+    for (size_t arc = 0; arc < remaining.size(); arc++) {
+        remaining[arc] = this->residual[arc] < this->capacity() ? this->capacity() - this->residual[arc] : 0;
+    }
+    // sink side nodes whose unit of flow into the sink hasn't been assigned to a path yet
+    std::vector<uint8_t> sinkFlow(this->nodeCount, 0);
+    for (int node = 0; node < this->nodeCount; node++) {
+        sinkFlow[node] = this->side[node] == SinkSide && this->terminalResidual[node] == 0;
+    }
+
+    // current-arc pointers, so each arc is skipped at most once overall. Index degree stands for the sink arc
+    std::vector<uint32_t> cursor(this->arcOffsets.begin(), this->arcOffsets.end() - 1);
+    // index in path of the arc leaving each node, or -1 if the node isn't on the path
+    std::vector<int> pathPosition(this->nodeCount, -1);
+    // (node, global arc) pairs
+    std::vector<std::pair<int, uint32_t>> path;
+    std::vector<std::pair<int, int>> arcs;
+
+    for (int first : this->sourceSide) {
+        if (this->terminalResidual[first] > 0) {
+            // no flow left the source through this node
+            continue;
+        }
+        path.clear();
+        int current = first;
+        while (true) {
+            uint32_t end = this->arcOffsets[current + 1];
+            while (cursor[current] < end && remaining[cursor[current]] == 0) {
+                cursor[current]++;
+            }
+            if (cursor[current] == end) {
+                // flow is conserved, so a node with nothing left flowing out has to be where a path ends
+                assert(sinkFlow[current]);
+                sinkFlow[current] = 0;
+                break;
+            }
+            uint32_t arc = cursor[current];
+            int next = this->arcHeads[arc];
+
+            if (pathPosition[next] != -1) {
+                // walked into a cycle of flow (possibly back through first, which is on the path too), cancel it and carry on
+                // from where it started
+                size_t cycleStart = pathPosition[next];
+                remaining[arc]--;
+                for (size_t index = cycleStart; index < path.size(); index++) {
+                    remaining[path[index].second]--;
+                    pathPosition[path[index].first] = -1;
+                }
+                path.resize(cycleStart);
+                current = next;
+                continue;
+            }
+            pathPosition[current] = static_cast<int>(path.size());
+            path.push_back({current, arc});
+            current = next;
+        }
+
+        arcs.clear();
+        for (auto [node, arc] : path) {
+            remaining[arc]--;
+            pathPosition[node] = -1;
+            arcs.push_back({node, static_cast<int>(arc - this->arcOffsets[node])});
+        }
+        onPath(first, current, arcs);
+    }
+}
+
+template <typename Residual, CapacityMode Mode>
+Subset CSRFlowKernel<Residual, Mode>::minCutSourceSide() const {
+    std::vector<bool> reached(this->nodeCount, false);
+    std::vector<int> frontier;
+    for (int node : this->sourceSide) {
+        if (this->terminalResidual[node] > 0) {
+            reached[node] = true;
+            frontier.push_back(node);
+        }
+    }
+    for (size_t next = 0; next < frontier.size(); next++) {
+        int node = frontier[next];
+        for (uint32_t arc = this->arcOffsets[node]; arc < this->arcOffsets[node + 1]; arc++) {
+            int head = this->arcHeads[arc];
+            if (this->residual[arc] > 0 && !reached[head]) {
+                reached[head] = true;
+                frontier.push_back(head);
+            }
+        }
+    }
+    std::sort(frontier.begin(), frontier.end());
+    return frontier;
+}
+
+template <typename Residual, CapacityMode Mode>
+int CSRFlowKernel<Residual, Mode>::warmStartedFlow() const {
+    return this->lastWarmStartedFlow;
+}
+
+template class CSRFlowKernel<uint8_t, CapacityMode::Unit>;
+template class CSRFlowKernel<uint8_t, CapacityMode::PhiScaled>;
+template class CSRFlowKernel<uint16_t, CapacityMode::PhiScaled>;
+template class CSRFlowKernel<int32_t, CapacityMode::PhiScaled>;
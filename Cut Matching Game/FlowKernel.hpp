@@ -0,0 +1,114 @@
+//
+//  FlowKernel.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Max flow for the matching player, specialized at compile time for the capacities a game uses.
+// The graph is laid out once as CSR with the index of every arc's reverse (a FlowLayout), so a round doesn't copy the graph or
+// search adjacency lists for reverse edges. The layout only depends on the graph, so every kernel on the same graph shares it: the
+// concurrent flows of a game, and the games --phi-search plays. The super source and sink aren't nodes: every node just knows which side of the cut it's on and
+// whether its unit of source (or sink) capacity is used up.
+// Inner arcs start at phiInverse and never hold more than 2 * phiInverse, so residuals are stored in the narrowest type that fits,
+// and the unit capacity kernel knows its capacity at compile time. FlowKernel::create picks the kernel once, so the inner loops
+// don't branch on any of it.
+// Augmenting paths are found the way EdmondsKarpMaxFlow finds them (BFS from the source side in node order, arcs in adjacency order)
+// so games play out the same.
+// With a warm start, source side nodes are first greedily routed to unused sink side nodes one or two hops away, which is most of the
+// flow on well connected graphs, and the BFS only has to find what's left. The flow is still maximum, but it's made of different
+// paths, so the matchings (and the game) change.
+
+#ifndef FlowKernel_hpp
+#define FlowKernel_hpp
+
+#include "Graph.hpp"
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+class FlowLayout {
+public:
+    explicit FlowLayout(const Graph& graph);
+    const int nodeCount;
+    // arcs of node u are arcOffsets[u] .. arcOffsets[u + 1], in adjacency list order
+    std::vector<uint32_t> arcOffsets;
+    std::vector<int32_t> arcHeads;
+    std::vector<uint32_t> reverseArcs;
+};
+
+class FlowKernel {
+public:
+    virtual ~FlowKernel() = default;
+    // picks the narrowest kernel for phiInverse. Only the residual capacities and search state are the kernel's own
+    static std::unique_ptr<FlowKernel> create(std::shared_ptr<const FlowLayout> layout, int phiInverse, bool warmStart);
+    // which kernel this is, e.g. "phi/uint16"
+    virtual const char* name() const = 0;
+    // max flow from the nodes in cut.first (one unit each) to the nodes in cut.second (one unit each), with phiInverse on every edge
+    virtual int computeMaxFlow(const Cut& cut) = 0;
+    // (cut.second node, cut.first node) at the ends of every augmenting path. Each node shows up at most once
+    virtual Matching matching() const = 0;
+    // splits the flow into unit paths (canceling any cycles of flow it runs into), see CSRFlowKernel::decomposeFlowPaths.
+    // arcs are (node, adjacency index) pairs in the graph
+    virtual void decomposeFlowPaths(const std::function<void(int, int, const std::vector<std::pair<int, int>>&)>& onPath) const = 0;
+    // nodes reachable from the source side in the residual graph, i.e. the source side of a minimum cut
+    virtual Subset minCutSourceSide() const = 0;
+    // units of the last flow the warm start routed
+    virtual int warmStartedFlow() const = 0;
+};
+
+enum class CapacityMode {
+    // every inner arc has capacity 1
+    Unit,
+    // every inner arc has capacity phiInverse
+    PhiScaled,
+};
+
+template <typename Residual, CapacityMode Mode>
+class CSRFlowKernel : public FlowKernel {
+public:
+    CSRFlowKernel(std::shared_ptr<const FlowLayout> layout, int phiInverse, bool warmStart);
+    const char* name() const override;
+    int computeMaxFlow(const Cut& cut) override;
+    Matching matching() const override;
+    void decomposeFlowPaths(const std::function<void(int, int, const std::vector<std::pair<int, int>>&)>& onPath) const override;
+    Subset minCutSourceSide() const override;
+    int warmStartedFlow() const override;
+private:
+    const std::shared_ptr<const FlowLayout> layout;
+    const int nodeCount;
+    const int phiInverse;
+    const bool warmStart;
+    // the layout's, named here so the flow reads like it owns them
+    const std::vector<uint32_t>& arcOffsets;
+    const std::vector<int32_t>& arcHeads;
+    const std::vector<uint32_t>& reverseArcs;
+    std::vector<Residual> residual;
+
+    // side of every node in the current cut, and whether its source or sink arc still has capacity
+    enum Side : uint8_t { None, SourceSide, SinkSide };
+    std::vector<uint8_t> side;
+    std::vector<uint8_t> terminalResidual;
+    std::vector<int> sourceSide;
+
+    // BFS state. A node is visited if its stamp is the current one, which saves clearing it for every search
+    std::vector<uint32_t> visitStamp;
+    uint32_t stamp = 0;
+    std::vector<uint32_t> parentArc;
+    std::vector<int> queue;
+    Matching pairs;
+    // for each node, the first arc that could still lead to an unused sink side node during the warm start
+    std::vector<uint32_t> sinkCursor;
+    int lastWarmStartedFlow = 0;
+
+    Residual capacity() const;
+    // sends one unit from a source side node to a sink side node along arcs, marking both terminals used
+    void routeUnit(int from, int to, std::initializer_list<uint32_t> arcs);
+    // greedily routes source side nodes to unused sink side nodes one hop away, then two hops away. Returns the units routed
+    int routeShortPaths();
+    // returns the sink side node the path ends at, or -1 if there's no augmenting path
+    int findPath();
+};
+
+#endif /* FlowKernel_hpp */
@@ -6,24 +6,42 @@
 //
 
 #include "Game.hpp"
-#include "EdmondsKarpMaxFlow.hpp"
-#include "PushRelabelMaxFlow.hpp"
+#include "MemoryProfile.hpp"
+#include "Reordering.hpp"
+#include "Screening.hpp"
+#include <chrono>
 #include <random>
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <filesystem>
+#include <future>
+#include <sstream>
 
 #include <iostream>
 
-std::random_device dev;
-std::mt19937 gen(dev());
-std::uniform_real_distribution<double> dis(0, 1);
+// how far below the mixing threshold the estimated potential has to be before we trust it
+const double POTENTIAL_SAFETY_FACTOR = 16;
 
-Game::Game(const Graph& graph, int firstActiveNode, int pastActiveNode, int phiInverse, int randomVectorCount) : graph(graph), phiInverse(phiInverse), activeNodeCount(pastActiveNode - firstActiveNode), firstActiveNode(firstActiveNode), pastActiveNode(pastActiveNode),  randomVectorCount(randomVectorCount) {
+Game::Game(const Graph& graph, int firstActiveNode, int pastActiveNode, const GameOptions& options) : graph(graph), options(options), phiInverse(options.phiInverse), activeNodeCount(pastActiveNode - firstActiveNode), firstActiveNode(firstActiveNode), pastActiveNode(pastActiveNode),  randomVectorCount(options.randomVectorCount), gen(options.seed ? *options.seed : std::random_device()()), output(*options.output), errors(*options.errors) {
     if (randomVectorCount != -1) {
-        std::cout << "Using at maximum " << randomVectorCount << " random vectors\n";
+        this->output << "Using at maximum " << randomVectorCount << " random vectors\n";
         randomVectorCache.reserve(randomVectorCount);
     }
+    if (options.cutPlayer != CutPlayer::KRV) {
+        this->output << "Using the " << cutPlayerName(options.cutPlayer) << " cut player\n";
+    }
+    MemoryProfile::Scope scope(MemoryProfile::Residual);
+    std::shared_ptr<const FlowLayout> layout = options.flowLayout ? options.flowLayout : std::make_shared<const FlowLayout>(graph);
+    assert(layout->nodeCount == graph.nodeCount());
+    // every concurrent flow needs its own residual capacities, but they all share the layout
+    for (int flow = 0; flow < options.parallelCuts; flow++) {
+        this->flows.push_back(FlowKernel::create(layout, this->phiInverse, options.warmStart));
+    }
+    this->output << "Using the " << this->flows[0]->name() << " flow kernel" << (options.warmStart ? " with a greedy warm start" : "") << "\n";
+    if (options.parallelCuts > 1) {
+        this->pool = std::make_unique<ThreadPool>(options.parallelCuts);
+    }
 }
 
 std::vector<double> Game::generateRandomVector() {
@@ -32,7 +50,7 @@ std::vector<double> Game::generateRandomVector() {
     
     double sum = 0;
     for(int i = 0; i < this->activeNodeCount; ++i) {
-        double next = dis(gen);
+        double next = dis(this->gen);
         random_vector[i] = next;
         sum += next * next;
     }
@@ -46,11 +64,11 @@ std::vector<double> Game::generateRandomVector() {
 }
 
 
-std::vector<double> Game::computeProjection() {
-    std::vector<double> random_vector = this->generateRandomVector();
+ProjectionVector Game::computeProjection() {
+    ProjectionVector random_vector(this->generateRandomVector(), this->options.vectorPrecision, this->options.precisionCheck);
     
     for (auto& matching : this->matchings) {
-        applyMatchingToVector(random_vector, matching);
+        random_vector.applyMatching(matching, this->firstActiveNode);
     }
     
     return random_vector;
@@ -58,127 +76,640 @@ std::vector<double> Game::computeProjection() {
 
 
 void Game::applyMatchingToVector(std::vector<double>& posVector, const Matching& match) {
-    for (auto& pair : match) {
-        // assert that all matchings are between split nodes
-        assert(firstActiveNode <= pair.first && pair.first < pastActiveNode);
-        assert(firstActiveNode <= pair.second && pair.second < pastActiveNode);
-        int shiftedFirst = pair.first - firstActiveNode;
-        int shiftedSecond = pair.second - firstActiveNode;
-        // set both nodes in the matching to the average
-        double avg = (posVector[shiftedFirst] + posVector[shiftedSecond]) / 2;
-        posVector[shiftedFirst] = avg;
-        posVector[shiftedSecond] = avg;
-    }
+    averageAlongMatching(posVector, match, this->firstActiveNode);
 }
 
 
 void Game::applyMatchingToCachedVectors(const Matching& match) {
     for (auto& vec : this->randomVectorCache) {
-        applyMatchingToVector(vec, match);
+        vec.applyMatching(match, this->firstActiveNode);
     }
 }
 
-std::pair<Subset, Subset> Game::generateCut() {
-    std::vector<double> posVector;
+std::pair<Subset, Subset> Game::generateCut(int vectorOffset) {
+    switch (this->options.cutPlayer) {
+        case CutPlayer::Multi:
+            return this->multiProjectionCut();
+        case CutPlayer::Power:
+            return this->powerIterationCut();
+        case CutPlayer::KRV:
+            break;
+    }
     if (this->randomVectorCount != -1) {
-        posVector = this->randomVectorCache[this->currentRound % this->randomVectorCount];
-    } else {
+        return this->splitAtMedian(this->randomVectorCache[(this->currentRound + vectorOffset) % this->randomVectorCount]);
+    }
+    ProjectionVector posVector;
+    {
+        MemoryProfile::Scope scope(MemoryProfile::Projection);
         posVector = this->computeProjection();
     }
-    
-    // so we can keep track of position and node when we find median
-    std::vector<std::pair<double, int>> pairedPosVector;
-    pairedPosVector.reserve(posVector.size());
-    
-    int index = 0;
-    for (double pos : posVector) {
-        pairedPosVector.push_back({pos, index});
-        index++;
+    return this->splitAtMedian(posVector);
+}
+
+// Several projections span a random slice of what the walk hasn't mixed yet, and their principal direction is the slowest mixing
+// direction in that slice, which is closer to the walk's slowest direction than any one projection
+Cut Game::multiProjectionCut() {
+    std::vector<double> combined(this->activeNodeCount, 0);
+    {
+        MemoryProfile::Scope scope(MemoryProfile::Projection);
+        std::vector<std::vector<double>> projections;
+        for (int vector = 0; vector < MULTI_PLAYER_VECTORS; vector++) {
+            std::vector<double> projection = this->generateRandomVector();
+            for (auto& matching : this->matchings) {
+                this->applyMatchingToVector(projection, matching);
+            }
+            centerVector(projection);
+            projections.push_back(std::move(projection));
+        }
+        std::vector<double> direction = principalDirection(projections);
+        for (int vector = 0; vector < MULTI_PLAYER_VECTORS; vector++) {
+            for (int node = 0; node < this->activeNodeCount; node++) {
+                combined[node] += direction[vector] * projections[vector][node];
+            }
+        }
     }
-    
-    auto compare = [](std::pair<double, int> &left, std::pair<double, int> &right) {
-        return left.first < right.first;
-    };
-    
-    std::vector<std::pair<double, int>>::iterator median = pairedPosVector.begin() + this->activeNodeCount / 2;
-    
-    // rearranges the array in O(n) time to get everything below the median in the first half of the array and everything equal to or above in the second half
-    std::nth_element(pairedPosVector.begin(), median, pairedPosVector.end(), compare);
-    
-    Subset cut, notCut;
-    cut.reserve(this->activeNodeCount / 2);
-    // in case its odd
-    notCut.reserve((this->activeNodeCount / 2) + 1);
-    
-    for (auto it = pairedPosVector.begin(); it != pairedPosVector.end(); it++) {
-        if (it < median) {
-            cut.push_back(it->second + this->firstActiveNode);
+    MemoryProfile::Scope scope(MemoryProfile::CutPlayer);
+    return ::splitAtMedian(combined, this->firstActiveNode);
+}
+
+// Power iteration on W^T W (W being the product of the matchings' averaging matrices, each its own transpose, so W^T applies them
+// in reverse) converges to the direction the walk mixes slowest in, which is what gets projected through W
+Cut Game::powerIterationCut() {
+    std::vector<double> direction;
+    {
+        MemoryProfile::Scope scope(MemoryProfile::Projection);
+        direction = this->generateRandomVector();
+        centerVector(direction);
+        for (int step = 0; step < POWER_PLAYER_STEPS; step++) {
+            for (auto& matching : this->matchings) {
+                this->applyMatchingToVector(direction, matching);
+            }
+            for (auto matching = this->matchings.rbegin(); matching != this->matchings.rend(); matching++) {
+                this->applyMatchingToVector(direction, *matching);
+            }
+            centerVector(direction);
+            double length = std::sqrt(centeredEnergy(direction));
+            if (length == 0) {
+                // the walk has mixed every direction we could find
+                break;
+            }
+            for (double& value : direction) {
+                value /= length;
+            }
+        }
+        for (auto& matching : this->matchings) {
+            this->applyMatchingToVector(direction, matching);
+        }
+        centerVector(direction);
+    }
+    MemoryProfile::Scope scope(MemoryProfile::CutPlayer);
+    return ::splitAtMedian(direction, this->firstActiveNode);
+}
+
+Cut Game::splitAtMedian(const ProjectionVector& posVector) {
+    MemoryProfile::Scope scope(MemoryProfile::CutPlayer);
+    Cut cut = posVector.splitAtMedian(this->firstActiveNode);
+    if (posVector.hasReference()) {
+        if (posVector.referenceAboveRoundingFloor()) {
+            this->checkPrecision(posVector, cut);
         } else {
-            notCut.push_back(it->second + this->firstActiveNode);
+            this->precisionUncheckedCuts++;
         }
     }
-    
-    return {cut, notCut};
+    return cut;
 }
 
-Matching Game::generateMatching(const Cut& cut, Graph graph) {
-    std::pair<int, int> sourceSink = graph.addSourceSink(cut);
-    
-    int targetFlow = this->activeNodeCount / 2;
-    
-    // target max flow should be n/2 where n is number of split nodes (so basically m/2)
-    EdmondsKarpMaxFlow flow(graph, sourceSink.first, sourceSink.second, targetFlow, phiInverse);
-    //PushRelabelMaxFlow pushFlow(graph, sourceSink.first, sourceSink.second, targetFlow, phiInverse);
+void Game::checkPrecision(const ProjectionVector& posVector, const Cut& cut) {
+    this->precisionCheckedCuts++;
+    Cut exact = posVector.splitReferenceAtMedian(this->firstActiveNode);
+    Subset side = cut.first;
+    std::sort(side.begin(), side.end());
+    std::sort(exact.first.begin(), exact.first.end());
+    Subset moved;
+    std::set_difference(side.begin(), side.end(), exact.first.begin(), exact.first.end(), std::back_inserter(moved));
+    if (moved.empty()) {
+        return;
+    }
+    this->precisionChangedRounds++;
+    this->mostNodesMoved = std::max(this->mostNodesMoved, static_cast<int>(moved.size()));
+    this->output << "Precision check: " << vectorPrecisionName(this->options.vectorPrecision) << " vectors put " << moved.size() << " of " << side.size() << " nodes on the other side of round " << this->currentRound + 1 << "'s cut\n";
+}
 
-    int maxFlow = flow.computeMaxFlow();
-    //int pushMaxFlow = pushFlow.computeMaxFlow();
+std::optional<Matching> Game::generateMatching(const Cut& cut) {
+    int maxFlow;
+    {
+        MemoryProfile::Scope residualScope(MemoryProfile::Residual);
+        maxFlow = this->flows[0]->computeMaxFlow(cut);
+    }
+    return this->collectMatching(cut, *this->flows[0], maxFlow);
+}
+
+std::optional<Matching> Game::collectMatching(const Cut& cut, const FlowKernel& flow, int maxFlow) {
+    // every node on the first side has to be routed, which is n/2 where n is number of split nodes (so basically m/2) for a median split
+    int targetFlow = static_cast<int>(cut.first.size());
+    this->totalFlow += maxFlow;
+    this->warmStartedFlow += flow.warmStartedFlow();
     
     // explicitly flush
-    std::cout << "Edmonds Karp Max Flow: " << maxFlow << " | Target was " << targetFlow << std::endl;
+    this->output << "Edmonds Karp Max Flow: " << maxFlow << " | Target was " << targetFlow << std::endl;
     
     if (maxFlow < targetFlow) {
-        std::cout << "Found 1/" << phiInverse << " cut in graph. Quitting\n";
-        std::cout << "Took " << this->matchings.size() + 1 << " rounds to find the cut\n";
-        exit(0);
+        this->cutWitness = flow.minCutSourceSide();
+        this->output << "Found 1/" << phiInverse << " cut in graph. Quitting\n";
+        return std::nullopt;
     }
-    // We can use a quirk of the graph setup / edmonds karp to find the matching within the edmonds karp flow process, without having to seperately decompse it
+    MemoryProfile::Scope matchingScope(MemoryProfile::Matchings);
     Matching match;
-    match.reserve(flow.matching.size());
-    match.assign(flow.matching.begin(), flow.matching.end());
-    //Matching match = flow.decomposeFlow();
+    if (this->certificate) {
+        // the certificate needs the actual paths, so decompose the flow and match the ends of each path
+        match.reserve(targetFlow);
+        this->certificate->beginRound();
+        flow.decomposeFlowPaths([this, &match](int first, int last, const std::vector<std::pair<int, int>>& arcs) {
+            {
+                MemoryProfile::Scope scope(MemoryProfile::Certificate);
+                this->certificate->addPath(first, last, arcs);
+            }
+            match.push_back({last, first});
+        });
+        return match;
+    }
+    // the kernel records the ends of every augmenting path as it goes, so there's no need to seperately decompose the flow
+    match = flow.matching();
     
     return match;
 }
 
 void Game::bumpRound(Matching matching) {
-    this->matchings.push_back(matching);
-    this->currentRound++;
     if (this->randomVectorCount != -1) {
         applyMatchingToCachedVectors(matching);
     }
+    std::string rngState;
+    if (this->checkpoint) {
+        MemoryProfile::Scope scope(MemoryProfile::Checkpoint);
+        rngState = this->rngState();
+    }
+    this->recordRound(std::move(matching), rngState);
+}
+
+void Game::restoreRound(Matching matching) {
+    if (this->randomVectorCount != -1) {
+        applyMatchingToCachedVectors(matching);
+    }
+    this->appendMatching(std::move(matching));
+}
+
+void Game::recordRound(Matching matching, const std::string& rngState) {
+    if (this->checkpoint) {
+        MemoryProfile::Scope scope(MemoryProfile::Checkpoint);
+        this->checkpoint->appendRound(this->currentRound, matching, rngState);
+    }
+    this->appendMatching(std::move(matching));
+}
+
+void Game::appendMatching(Matching matching) {
+    MemoryProfile::Scope scope(MemoryProfile::Matchings);
+    for (auto& probe : this->potentialProbes) {
+        applyMatchingToVector(probe, matching);
+    }
+    this->matchings.push_back(std::move(matching));
+    this->currentRound++;
+}
+
+std::string Game::rngState() const {
+    std::ostringstream state;
+    state << this->gen;
+    return state.str();
+}
+
+CheckpointHeader Game::checkpointHeader() const {
+    return {
+        this->graph.fingerprint(),
+        this->graph.nodeCount(),
+        this->firstActiveNode,
+        this->pastActiveNode,
+        this->phiInverse,
+        this->randomVectorCount,
+        static_cast<int32_t>(this->potentialProbeCount()),
+        static_cast<int32_t>(this->options.vectorPrecision),
+        static_cast<int32_t>(this->options.cutPlayer),
+        this->options.parallelCuts,
+        this->options.warmStart ? 1 : 0,
+    };
+}
+
+bool Game::startCheckpoint() {
+    MemoryProfile::Scope scope(MemoryProfile::Checkpoint);
+    this->checkpoint = std::make_unique<Checkpoint>(this->options.checkpointPath, this->errors);
+    this->checkpoint->setFlushInterval(this->options.checkpointInterval);
+    CheckpointHeader expected = this->checkpointHeader();
+
+    CheckpointState state;
+    if (this->options.resume && this->checkpoint->load(state)) {
+        const CheckpointHeader& saved = state.header;
+        if (saved.graphFingerprint != expected.graphFingerprint || saved.nodeCount != expected.nodeCount) {
+            this->errors << "Checkpoint (" << this->options.checkpointPath << ") was written for a different graph\n";
+            return false;
+        }
+        if (saved.firstActiveNode != expected.firstActiveNode || saved.pastActiveNode != expected.pastActiveNode ||
+            saved.phiInverse != expected.phiInverse || saved.randomVectorCount != expected.randomVectorCount ||
+            saved.potentialProbeCount != expected.potentialProbeCount || saved.vectorPrecision != expected.vectorPrecision ||
+            saved.cutPlayer != expected.cutPlayer || saved.parallelCuts != expected.parallelCuts ||
+            saved.warmStart != expected.warmStart) {
+            this->errors << "Checkpoint (" << this->options.checkpointPath << ") was written with different options\n";
+            return false;
+        }
+        // cached vectors aren't saved per round, so rebuild them by replaying every matching onto the initial vectors
+        // the initial vectors are the cache followed by the potential probes
+        size_t cacheSize = state.initialVectors.size() - saved.potentialProbeCount;
+        MemoryProfile::Scope cacheScope(MemoryProfile::VectorCache);
+        this->randomVectorCache.clear();
+        for (size_t index = 0; index < cacheSize; index++) {
+            this->randomVectorCache.emplace_back(state.initialVectors[index], this->options.vectorPrecision, this->options.precisionCheck);
+        }
+        this->setPotentialProbes({std::make_move_iterator(state.initialVectors.begin() + cacheSize), std::make_move_iterator(state.initialVectors.end())});
+        for (auto& matching : state.matchings) {
+            this->restoreRound(std::move(matching));
+        }
+        std::istringstream(state.rngState) >> this->gen;
+        this->output << "Resuming from checkpoint at round " << this->currentRound << "\n";
+        return true;
+    }
+
+    if (this->options.resume) {
+        std::error_code error;
+        if (std::filesystem::exists(this->options.checkpointPath, error)) {
+            // load already said what's wrong with it. Starting over would overwrite the rounds it does hold
+            this->errors << "Not overwriting checkpoint (" << this->options.checkpointPath << ") that couldn't be resumed from\n";
+            return false;
+        }
+        this->output << "No checkpoint to resume from at " << this->options.checkpointPath << ". Starting a new game\n";
+    }
+    std::vector<std::vector<double>> initialVectors;
+    this->generateInitialVectors(&initialVectors);
+    return this->checkpoint->begin(expected, initialVectors, this->rngState());
+}
+
+void Game::generateInitialVectors(std::vector<std::vector<double>>* initialVectors) {
+    MemoryProfile::Scope scope(MemoryProfile::VectorCache);
+    // no matchings have been played yet, so these are the initial vectors as they are
+    if (this->randomVectorCount != -1) {
+        this->randomVectorCache.reserve(this->randomVectorCount);
+        for (int index = 0; index < this->randomVectorCount; index++) {
+            std::vector<double> vec = this->generateRandomVector();
+            this->randomVectorCache.emplace_back(vec, this->options.vectorPrecision, this->options.precisionCheck);
+            if (initialVectors) {
+                initialVectors->push_back(std::move(vec));
+            }
+        }
+    }
+    std::vector<std::vector<double>> probes;
+    probes.reserve(this->potentialProbeCount());
+    for (int index = 0; index < this->potentialProbeCount(); index++) {
+        probes.push_back(this->generateRandomVector());
+    }
+    if (initialVectors) {
+        initialVectors->insert(initialVectors->end(), probes.begin(), probes.end());
+    }
+    this->setPotentialProbes(std::move(probes));
+}
+
+int Game::potentialProbeCount() const {
+    return this->options.earlyStop ? this->options.potentialProbeCount : 0;
+}
+
+// sum of squared distances from the mean. Averaging along a matching preserves the mean, so this only shrinks as the walk mixes
+double Game::centeredEnergy(const std::vector<double>& vec) {
+    double mean = 0;
+    for (double value : vec) {
+        mean += value;
+    }
+    mean /= vec.size();
+
+    double energy = 0;
+    for (double value : vec) {
+        energy += (value - mean) * (value - mean);
+    }
+    return energy;
 }
 
-void Game::run() {
+// subtracts the mean from every value, so only the part of a vector the walk hasn't mixed away is left
+void Game::centerVector(std::vector<double>& vec) {
+    double mean = 0;
+    for (double value : vec) {
+        mean += value;
+    }
+    mean /= vec.size();
+    for (double& value : vec) {
+        value -= mean;
+    }
+}
+
+void Game::setPotentialProbes(std::vector<std::vector<double>> probes) {
+    this->potentialProbes = std::move(probes);
+    this->probeInitialEnergy.clear();
+    for (const auto& probe : this->potentialProbes) {
+        this->probeInitialEnergy.push_back(centeredEnergy(probe));
+    }
+}
+
+// Let W be the (doubly stochastic) product of the averaging matrices of every matching so far. The KRV potential is
+// sum_i ||W e_i - 1/n||^2 = ||W - J/n||_F^2, which is n - 1 before any matching.
+// For a vector r with iid entries, E||(W - J/n) r||^2 is proportional to ||W - J/n||_F^2, and (W - J/n) r is just W r centered,
+// so each probe's centered energy relative to its starting energy estimates potential / (n - 1)
+double Game::estimatePotential() const {
+    double ratio = 0;
+    for (size_t index = 0; index < this->potentialProbes.size(); index++) {
+        ratio += centeredEnergy(this->potentialProbes[index]) / this->probeInitialEnergy[index];
+    }
+    ratio /= this->potentialProbes.size();
+    return ratio * (this->activeNodeCount - 1);
+}
+
+// If the potential is at most 1/(4n^2), every row of W is within 1/(2n) of uniform (in l2, so also in every entry),
+// i.e. every node has sent at least 1/(2n) of its mass to every other node through the matchings, so their union is an expander.
+// The estimate is noisy, so it has to clear the threshold by POTENTIAL_SAFETY_FACTOR
+bool Game::potentialCertifiesMixing(double potential) const {
+    double n = this->activeNodeCount;
+    return potential * POTENTIAL_SAFETY_FACTOR <= 1 / (4 * n * n);
+}
+
+std::optional<GameResult> Game::run() {
     //int originalNodeCount = static_cast<double>(firstSplitNode);
     int originalNodeCount = this->graph.nodeCount();
     int rounds = std::ceil(pow(std::log2(originalNodeCount), 2));
     if (rounds < 10) {
-        std::cout << "Estimated Rounds: " << rounds << ". Using a minimum of 10 rounds\n";
+        this->output << "Estimated Rounds: " << rounds << ". Using a minimum of 10 rounds\n";
         rounds = 10;
     } else {
-        std::cout << "Estimated Rounds: " << rounds << "\n";
+        this->output << "Estimated Rounds: " << rounds << "\n";
     }
-    // generate random vectors ahead of time. could be done on demand as well
-    if (this->randomVectorCount != -1) {
-        this->randomVectorCache.reserve(this->randomVectorCount);
-        for (int index = 0; index < this->randomVectorCount; index++) {
-            this->randomVectorCache.push_back(this->computeProjection());
+    if (this->options.parallelCuts > 1) {
+        // the same number of matchings, parallelCuts at a time
+        rounds = (rounds + this->options.parallelCuts - 1) / this->options.parallelCuts;
+        this->output << "Playing " << this->options.parallelCuts << " cuts per round, so " << rounds << " rounds\n";
+    }
+    if (std::optional<GameResult> screened = this->screen()) {
+        return screened;
+    }
+    if (!this->options.checkpointPath.empty()) {
+        if (!this->startCheckpoint()) {
+            return std::nullopt;
+        }
+    } else {
+        // generate random vectors ahead of time. could be done on demand as well
+        this->generateInitialVectors();
+    }
+    if (!this->options.certificatePath.empty()) {
+        if (this->currentRound > 0) {
+            // the paths for restored rounds are gone, and a certificate missing rounds doesn't certify anything
+            this->errors << "Can't write a certificate for a game resumed from a checkpoint. Not writing one\n";
+        } else {
+            MemoryProfile::Scope scope(MemoryProfile::Certificate);
+            this->certificate = std::make_unique<EmbeddingCertificate>(this->graph);
         }
     }
-    for (int i = 0; i < rounds; i++) {
-        Cut cut = this->generateCut();
-        Matching match = this->generateMatching(cut, graph);
-        this->bumpRound(match);
+    GameResult result;
+    if (this->options.parallelCuts > 1) {
+        result = this->runParallel(rounds);
+    } else if (this->options.pipelined) {
+        result = this->runPipelined(rounds);
+    } else {
+        result = this->runSequential(rounds);
+    }
+    if (this->options.precisionCheck) {
+        this->output << "Precision check: " << vectorPrecisionName(this->options.vectorPrecision) << " vectors changed " << this->precisionChangedRounds << " of " << this->precisionCheckedCuts << " cuts checked";
+        if (this->precisionChangedRounds > 0) {
+            this->output << " (at most " << this->mostNodesMoved << " nodes moved)";
+        }
+        if (this->precisionUncheckedCuts > 0) {
+            this->output << ". " << this->precisionUncheckedCuts << " cuts came from vectors mixed below double's rounding error and weren't checked";
+        }
+        this->output << "\n";
+    }
+    if (this->options.warmStart && this->totalFlow > 0) {
+        this->output << "Warm start routed " << this->warmStartedFlow << " of " << this->totalFlow << " flow units (" << 100.0 * this->warmStartedFlow / this->totalFlow << "%)\n";
+    }
+    if (result.foundCut) {
+        result.witness = std::move(this->cutWitness);
+    } else {
+        this->output << "Couldn't find min cut. Graph should be a 1/" << phiInverse << " expander\n";
+        const VertexOrder* order = this->options.vertexOrder;
+        uint64_t fingerprint = order ? order->originalFingerprint : this->graph.fingerprint();
+        if (this->certificate && this->certificate->write(this->options.certificatePath, fingerprint, this->phiInverse, order ? &order->originalIds : nullptr, this->errors)) {
+            this->output << "Wrote embedding of " << this->certificate->roundCount() << " matchings with congestion " << this->certificate->maxCongestion() << " to " << this->options.certificatePath << "\n";
+        }
+    }
+    return result;
+}
+
+std::optional<GameResult> Game::screen() {
+    // screening cuts the whole graph, so it doesn't apply when only some nodes are in play
+    if (!this->options.screen || this->firstActiveNode != 0 || this->pastActiveNode != this->graph.nodeCount()) {
+        return std::nullopt;
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::optional<ScreeningResult> screened = screenForSparseCut(this->graph);
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!screened) {
+        return std::nullopt;
+    }
+    if (!screened->sparserThan(this->phiInverse)) {
+        this->output << "Screening found no 1/" << this->phiInverse << " cut in " << milliseconds << " ms (sparsest was a " << screened->kind << " cut with expansion " << screened->expansion << ")\n";
+        return std::nullopt;
+    }
+    this->output << "Screening found a " << screened->kind << " cut in " << milliseconds << " ms: " << screened->side.size() << " nodes with " << screened->cutEdges << " edges leaving, expansion " << screened->expansion << "\n";
+    this->output << "Found 1/" << phiInverse << " cut in graph. Quitting\n";
+    this->output << "Took 0 rounds to find the cut\n";
+    return GameResult{true, 0, std::move(screened->side)};
+}
+
+GameResult Game::cutFound() const {
+    int round = this->playedRounds() + 1;
+    this->output << "Took " << round << " rounds to find the cut\n";
+    return {true, round};
+}
+
+int Game::playedRounds() const {
+    int parallelCuts = this->options.parallelCuts;
+    return (this->currentRound + parallelCuts - 1) / parallelCuts;
+}
+
+GameResult Game::runSequential(int rounds) {
+    while (this->currentRound < rounds && !this->shouldStopEarly(rounds)) {
+        Cut cut;
+        {
+            MemoryProfile::Phase phase("cut");
+            cut = this->generateCut();
+        }
+        std::optional<Matching> match;
+        {
+            MemoryProfile::Phase phase("flow");
+            match = this->generateMatching(cut);
+        }
+        if (!match) {
+            return this->cutFound();
+        }
+        {
+            MemoryProfile::Phase phase("bump");
+            this->bumpRound(std::move(*match));
+        }
+        this->reportMemory();
+    }
+    return {false, this->currentRound};
+}
+
+// Every round draws parallelCuts cuts from the matchings so far and routes them at once, each on its own flow kernel, then adds
+// every matching. Rounds mix more, at the cost of each cut not seeing the other matchings of its round.
+// The cuts are drawn (and the flows reported) in order on this thread, so a seeded game plays out the same however the flows are
+// scheduled.
+GameResult Game::runParallel(int rounds) {
+    int parallelCuts = this->options.parallelCuts;
+    while (this->currentRound < rounds * parallelCuts && !this->shouldStopEarly(rounds)) {
+        std::vector<Cut> cuts(parallelCuts);
+        {
+            MemoryProfile::Phase phase("cut");
+            for (int index = 0; index < parallelCuts; index++) {
+                cuts[index] = this->generateCut(index);
+            }
+        }
+        std::vector<int> maxFlows(parallelCuts);
+        {
+            MemoryProfile::Phase phase("flow");
+            std::vector<std::future<int>> pending;
+            for (int index = 0; index < parallelCuts; index++) {
+                pending.push_back(this->pool->submit([this, &cuts, index] {
+                    MemoryProfile::Scope scope(MemoryProfile::Residual);
+                    return this->flows[index]->computeMaxFlow(cuts[index]);
+                }));
+            }
+            for (int index = 0; index < parallelCuts; index++) {
+                maxFlows[index] = pending[index].get();
+            }
+        }
+        std::vector<Matching> matches;
+        for (int index = 0; index < parallelCuts; index++) {
+            std::optional<Matching> match = this->collectMatching(cuts[index], *this->flows[index], maxFlows[index]);
+            if (!match) {
+                return this->cutFound();
+            }
+            matches.push_back(std::move(*match));
+        }
+        {
+            MemoryProfile::Phase phase("bump");
+            for (Matching& match : matches) {
+                this->bumpRound(std::move(match));
+            }
+        }
+        this->reportMemory();
+    }
+    return {false, this->playedRounds()};
+}
+
+// Round i + 1's projection only depends on round i's flow through the final matching, so it's prepared on a worker thread while
+// the flow runs, and only that last matching is applied once the flow finishes.
+// With a vector cache, only the vector the next round needs gets the new matching right away. The rest of the cache is updated
+// on a worker while the next round's flow runs.
+// Everything the worker reads (matchings, cache, RNG) is left alone on this thread until the worker is joined after the flow.
+GameResult Game::runPipelined(int rounds) {
+    bool useCache = this->randomVectorCount != -1;
+    // the projection for the round we're about to play, with every matching so far applied
+    ProjectionVector posVector;
+    {
+        MemoryProfile::Scope scope(MemoryProfile::Projection);
+        posVector = useCache ? this->randomVectorCache[this->currentRound % this->randomVectorCount] : this->computeProjection();
+    }
+    // if true, the last matching was only applied to the cache vector for the current round
+    bool cacheUpdateDeferred = false;
+
+    while (this->currentRound < rounds && !this->shouldStopEarly(rounds)) {
+        Cut cut;
+        {
+            MemoryProfile::Phase phase("cut");
+            cut = this->splitAtMedian(posVector);
+        }
+
+        // the next round's vector comes from the RNG state as of now, so that's what a checkpoint has to resume from
+        std::string rngState = (this->checkpoint && !useCache) ? this->rngState() : "";
+        std::future<ProjectionVector> nextProjection;
+        std::future<void> cacheUpdate;
+        if (useCache) {
+            if (cacheUpdateDeferred) {
+                cacheUpdate = std::async(std::launch::async, [this] {
+                    this->applyDeferredCacheUpdate();
+                });
+            }
+        } else {
+            nextProjection = std::async(std::launch::async, [this] {
+                MemoryProfile::Scope scope(MemoryProfile::Projection);
+                return this->computeProjection();
+            });
+        }
+
+        std::optional<Matching> match;
+        {
+            MemoryProfile::Phase phase("flow");
+            match = this->generateMatching(cut);
+        }
+
+        // join before touching anything the worker reads
+        if (cacheUpdate.valid()) {
+            cacheUpdate.get();
+        }
+        ProjectionVector next = nextProjection.valid() ? nextProjection.get() : ProjectionVector();
+        if (!match) {
+            return this->cutFound();
+        }
+
+        {
+            MemoryProfile::Phase phase("bump");
+            if (useCache) {
+                int nextIndex = (this->currentRound + 1) % this->randomVectorCount;
+                this->randomVectorCache[nextIndex].applyMatching(*match, this->firstActiveNode);
+                this->recordRound(std::move(*match), this->checkpoint ? this->rngState() : "");
+                MemoryProfile::Scope scope(MemoryProfile::Projection);
+                posVector = this->randomVectorCache[nextIndex];
+                cacheUpdateDeferred = true;
+            } else {
+                next.applyMatching(*match, this->firstActiveNode);
+                this->recordRound(std::move(*match), rngState);
+                posVector = std::move(next);
+            }
+        }
+        this->reportMemory();
+    }
+
+    // leave the cache consistent with every matching played
+    if (cacheUpdateDeferred) {
+        this->applyDeferredCacheUpdate();
+    }
+    return {false, this->currentRound};
+}
+
+void Game::applyDeferredCacheUpdate() {
+    int current = this->currentRound % this->randomVectorCount;
+    for (int index = 0; index < this->randomVectorCount; index++) {
+        if (index != current) {
+            this->randomVectorCache[index].applyMatching(this->matchings.back(), this->firstActiveNode);
+        }
+    }
+}
+
+void Game::reportMemory() const {
+    if (this->options.memoryProfile) {
+        MemoryProfile::reportRound(this->output, this->playedRounds());
+    }
+}
+
+// checked before every round, so resuming a finished game doesn't play an extra round
+bool Game::shouldStopEarly(int rounds) {
+    if (!this->options.earlyStop || this->currentRound == 0) {
+        return false;
+    }
+    double potential = this->estimatePotential();
+    this->output << "Estimated potential: " << potential << "\n";
+    if (this->potentialCertifiesMixing(potential)) {
+        this->output << "Potential certifies mixing after " << this->playedRounds() << " of " << rounds << " rounds. Stopping early\n";
+        return true;
     }
-    std::cout << "Couldn't find min cut. Graph should be a 1/" << phiInverse << " expander\n";
+    return false;
 }
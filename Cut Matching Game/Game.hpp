@@ -9,37 +9,175 @@
 #define Game_hpp
 
 #include "Graph.hpp"
+#include "Checkpoint.hpp"
+#include "Certificate.hpp"
+#include "CutPlayer.hpp"
+#include "FlowKernel.hpp"
+#include "ProjectionVector.hpp"
+#include "ThreadPool.hpp"
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <cstdint>
+#include <random>
+#include <string>
+
+struct VertexOrder;
+
+struct GameOptions {
+    // represents 1/phi, but as an int (since most phi is 1 / int) instead of a double
+    int phiInverse;
+    // represents how many randomVectors we should store
+    // if -1, keep them forever
+    int randomVectorCount = -1;
+    // if set, every round is appended to a binary checkpoint at this path
+    std::string checkpointPath;
+    // flush the checkpoint to disk every checkpointInterval rounds
+    int checkpointInterval = 1;
+    // continue from the checkpoint at checkpointPath (if there is one) instead of starting over
+    bool resume = false;
+    // stop before the planned rounds once the estimated random walk potential certifies the matchings mix
+    bool earlyStop = false;
+    // how many random vectors to track the potential with. More probes means a less noisy estimate
+    int potentialProbeCount = 8;
+    // prepare the next round's projection on a worker thread while the current round's flow runs
+    bool pipelined = false;
+    // if set and no cut is found, write the flow paths embedding every matching (and their congestion) here. The matchings are
+    // then taken from the decomposed flow instead of the ends of the augmenting paths, so the game plays out differently than
+    // without a certificate (the same seed gives different matchings, and can take a different number of rounds)
+    std::string certificatePath;
+    // print live/peak heap bytes per subsystem after every round (needs a -DCMG_MEMORY_PROFILE build for the breakdown)
+    bool memoryProfile = false;
+    // seeds the random vectors, so games with the same seed start from the same vectors. Picked at random if not set
+    std::optional<uint32_t> seed;
+    // set if the graph was relabeled after loading (see Reordering.hpp), so what's written out can use the input's ids
+    const VertexOrder* vertexOrder = nullptr;
+    // the flow kernels' layout of the graph the game is played on, for callers playing several games on one graph. Built by the
+    // game if not set
+    std::shared_ptr<const FlowLayout> flowLayout;
+    // what the random vectors are stored in. float and fixed point take half the memory of double
+    VectorPrecision vectorPrecision = VectorPrecision::Double;
+    // keep an exact copy of every vector and report whenever the reduced precision changes a cut
+    bool precisionCheck = false;
+    // greedily route the cut along one and two hop paths before the max flow's BFS (see FlowKernel.hpp). Changes the matchings
+    bool warmStart = false;
+    // cuts (and concurrent max flows) per round. The planned rounds shrink to match, so the game plays as many matchings
+    int parallelCuts = 1;
+    // how each round's cut is picked
+    CutPlayer cutPlayer = CutPlayer::KRV;
+    // look for an obvious sparse cut (see Screening.hpp) before playing, and report it after 0 rounds if there is one
+    bool screen = true;
+    // where progress and results are printed, and where problems with the checkpoint or certificate are reported
+    std::ostream* output = &std::cout;
+    std::ostream* errors = &std::cerr;
+};
+
+struct GameResult {
+    // true if the matching player couldn't route a cut, so the graph has a sparse cut
+    bool foundCut;
+    // rounds played, including the one that found the cut
+    int rounds;
+    // if a cut was found, the source side of the minimum cut that stopped the flow (a set of nodes with few edges leaving it)
+    Subset witness = {};
+};
 
 class Game {
 public:
     // pass indexes of the nodes to do cuts on (exclusive), because we can tune it to include split nodes or ignore it if we don't subdivide
-    Game(const Graph& graph, int firstActiveNode, int pastActiveNode, int phiInverse, int randomVectorCount);
+    Game(const Graph& graph, int firstActiveNode, int pastActiveNode, const GameOptions& options);
     // end the round by adding the matching player's submission to the matrix
     void bumpRound(Matching matching);
-    // returns both sides of a cut of split nodes
-    Cut generateCut();
-    // need to copy the graph so we can add temporary source/sinks
-    Matching generateMatching(const Cut& cut, Graph graph);
-    void run();
+    // returns both sides of a cut of split nodes. With a vector cache, vectorOffset picks the cached vector that many after the
+    // current round's (for the other cuts of a parallel round)
+    Cut generateCut(int vectorOffset = 0);
+    // routes the cut with the game's flow kernel
+    // returns nothing if the cut can't be routed, i.e. we found a sparse cut
+    std::optional<Matching> generateMatching(const Cut& cut);
+    // returns nothing if the game couldn't be started (e.g. a bad checkpoint)
+    std::optional<GameResult> run();
 private:
     const Graph& graph;
     std::vector<Matching> matchings;
+    const GameOptions options;
     // represents 1/phi, but as an int (since most phi is 1 / int) instead of a double
     const int phiInverse;
     const int activeNodeCount;
     const int firstActiveNode;
     const int pastActiveNode;
-    int currentRound;
+    int currentRound = 0;
     // represents how many randomVectors we should store
     // if -1, keep them forever
     const int randomVectorCount;
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dis{0, 1};
+    std::unique_ptr<Checkpoint> checkpoint;
+    std::unique_ptr<EmbeddingCertificate> certificate;
+    // built once for the graph and phiInverse, and reused every round. One per parallel cut
+    std::vector<std::unique_ptr<FlowKernel>> flows;
+    // runs the parallel cuts' flows
+    std::unique_ptr<ThreadPool> pool;
+    // flow units over the whole game, and how many of them the warm start routed
+    int64_t totalFlow = 0;
+    int64_t warmStartedFlow = 0;
+    Subset cutWitness;
+    std::ostream& output;
+    std::ostream& errors;
     // apply the matching to the cached vectors
     void applyMatchingToCachedVectors(const Matching& match);
     void applyMatchingToVector(std::vector<double>& posVector, const Matching& match);
-    std::vector<std::vector<double>> randomVectorCache;
-    std::vector<double> computeProjection();
+    std::vector<ProjectionVector> randomVectorCache;
+    ProjectionVector computeProjection();
     std::vector<double> generateRandomVector();
-    double computeMedian(std::vector<double>& data) const;
+    // generates the random vector cache (if used) and the potential probes. If initialVectors is given, the vectors are copied
+    // into it as they were generated (the cache, then the probes)
+    void generateInitialVectors(std::vector<std::vector<double>>* initialVectors = nullptr);
+    // split the active nodes at the median of their positions
+    Cut splitAtMedian(const ProjectionVector& posVector);
+    // the cuts of the multi and power cut players
+    Cut multiProjectionCut();
+    Cut powerIterationCut();
+    // rounds where the precision check found reduced precision changed the cut, and the most nodes it moved in one round
+    int precisionChangedRounds = 0;
+    // cuts compared against the exact vectors, and cuts whose exact vectors had mixed past telling their nodes apart
+    int precisionCheckedCuts = 0;
+    int precisionUncheckedCuts = 0;
+    int mostNodesMoved = 0;
+    void checkPrecision(const ProjectionVector& posVector, const Cut& cut);
+    // returns the result if screening found a sparse cut
+    std::optional<GameResult> screen();
+    // reports the flow for cut that flow has already computed, and turns it into a matching. Returns nothing if the cut couldn't
+    // be routed
+    std::optional<Matching> collectMatching(const Cut& cut, const FlowKernel& flow, int maxFlow);
+    // reports a cut found in the round being played
+    GameResult cutFound() const;
+    // rounds played so far, each being parallelCuts matchings
+    int playedRounds() const;
+    GameResult runSequential(int rounds);
+    GameResult runParallel(int rounds);
+    GameResult runPipelined(int rounds);
+    // applies the last matching to every cached vector but the current round's, which runPipelined already gave it
+    void applyDeferredCacheUpdate();
+    bool shouldStopEarly(int rounds);
+    void reportMemory() const;
+    // add a matching that was already played (e.g. from a checkpoint) without recording it again
+    void restoreRound(Matching matching);
+    // add a matching (and write it to the checkpoint) without touching the cache
+    void recordRound(Matching matching, const std::string& rngState);
+    void appendMatching(Matching matching);
+    // load the checkpoint if resuming, otherwise start a new one. Returns false if we can't continue
+    bool startCheckpoint();
+    CheckpointHeader checkpointHeader() const;
+    std::string rngState() const;
+    // random vectors that only have the matchings applied to them, so their variance tracks how well the walk mixes
+    std::vector<std::vector<double>> potentialProbes;
+    std::vector<double> probeInitialEnergy;
+    int potentialProbeCount() const;
+    void setPotentialProbes(std::vector<std::vector<double>> probes);
+    static double centeredEnergy(const std::vector<double>& vec);
+    static void centerVector(std::vector<double>& vec);
+    // estimate of the KRV random walk potential of the matchings so far
+    double estimatePotential() const;
+    bool potentialCertifiesMixing(double potential) const;
 };
 
 
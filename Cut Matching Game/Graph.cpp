@@ -6,6 +6,10 @@
 //
 
 #include "Graph.hpp"
+#include "CSRFormat.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
 #include <sstream>
 #include <string>
 #include <iostream>
@@ -50,10 +54,192 @@ Graph::Graph( std::stringstream& buffer) {
     }
 }
 
+std::optional<Graph> Graph::readCSR(std::istream& input) {
+    CSRHeader header;
+    if (!input.read(reinterpret_cast<char*>(&header), sizeof(header)) || !std::equal(header.magic, header.magic + sizeof(header.magic), CSR_MAGIC)) {
+        std::cerr << "Input is not a CSR graph\n";
+        return std::nullopt;
+    }
+    if (header.version != CSR_VERSION) {
+        std::cerr << "Unsupported CSR graph version " << header.version << "\n";
+        return std::nullopt;
+    }
+    if (header.nodeCount > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+        std::cerr << "CSR graph has too many nodes (" << header.nodeCount << ")\n";
+        return std::nullopt;
+    }
+
+    if (header.arcCount > std::numeric_limits<uint32_t>::max()) {
+        // the flow kernel numbers arcs with 32 bits
+        std::cerr << "CSR graph has too many arcs (" << header.arcCount << ")\n";
+        return std::nullopt;
+    }
+    // don't allocate what a corrupt header claims before knowing the data is there
+    std::streampos dataStart = input.tellg();
+    if (dataStart != std::streampos(-1) && input.seekg(0, std::ios::end)) {
+        uint64_t available = static_cast<uint64_t>(input.tellg() - dataStart);
+        input.seekg(dataStart);
+        if ((header.nodeCount + 1) * sizeof(uint64_t) + header.arcCount * sizeof(uint32_t) > available) {
+            std::cerr << "CSR graph is truncated\n";
+            return std::nullopt;
+        }
+    }
+    input.clear();
+
+    std::vector<uint64_t> offsets(header.nodeCount + 1);
+    std::vector<uint32_t> neighbors(header.arcCount);
+    if (!input.read(reinterpret_cast<char*>(offsets.data()), offsets.size() * sizeof(uint64_t)) ||
+        !input.read(reinterpret_cast<char*>(neighbors.data()), neighbors.size() * sizeof(uint32_t))) {
+        std::cerr << "CSR graph is truncated\n";
+        return std::nullopt;
+    }
+    if (offsets.front() != 0 || offsets.back() != header.arcCount) {
+        std::cerr << "CSR graph offsets don't match its arc count\n";
+        return std::nullopt;
+    }
+    // with the ends pinned, offsets that never decrease keep every row inside the neighbors
+    for (uint64_t node = 0; node < header.nodeCount; node++) {
+        if (offsets[node] > offsets[node + 1]) {
+            std::cerr << "CSR graph offsets decrease at node " << node << "\n";
+            return std::nullopt;
+        }
+    }
+    for (uint32_t to : neighbors) {
+        if (to >= header.nodeCount) {
+            std::cerr << "CSR graph has an edge to missing node " << to << "\n";
+            return std::nullopt;
+        }
+    }
+
+    std::vector<std::vector<Edge>> adjacencyList(header.nodeCount);
+    for (uint64_t node = 0; node < header.nodeCount; node++) {
+        adjacencyList[node].reserve(offsets[node + 1] - offsets[node]);
+        for (uint64_t arc = offsets[node]; arc < offsets[node + 1]; arc++) {
+            uint32_t to = neighbors[arc];
+            // SKIP SELF LOOPS
+            if (to == node) {
+                continue;
+            }
+            adjacencyList[node].push_back(Edge(static_cast<int>(to), 1));
+        }
+    }
+    return Graph(std::move(adjacencyList));
+}
+
+std::optional<Graph> Graph::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file (" << path << "): " << strerror(errno) << "\n";
+        return std::nullopt;
+    }
+
+    char magic[sizeof(CSR_MAGIC)] = {};
+    file.read(magic, sizeof(magic));
+    bool isCSR = file.gcount() == sizeof(magic) && std::equal(magic, magic + sizeof(magic), CSR_MAGIC);
+    file.clear();
+    file.seekg(0);
+
+    std::optional<Graph> graph;
+    if (isCSR) {
+        graph = Graph::readCSR(file);
+    } else {
+        std::stringstream fileBuffer;
+        fileBuffer << file.rdbuf();
+        graph = Graph(fileBuffer);
+    }
+    int node;
+    if (graph && !graph->isSymmetric(node)) {
+        std::cerr << "Graph (" << path << ") isn't symmetric: node " << node + 1 << " has edges its neighbors don't list back\n";
+        return std::nullopt;
+    }
+    return graph;
+}
+
+bool Graph::isSymmetric(int& node) const {
+    // rows are visited in order, so the tails waiting for each node come out sorted, and have to equal its sorted lower neighbors
+    std::vector<std::vector<int>> waitingTails(this->nodeCount());
+    std::vector<int> lowerHeads;
+    for (node = 0; node < this->nodeCount(); node++) {
+        lowerHeads.clear();
+        for (const Edge& edge : this->adjacencyList[node]) {
+            if (edge.to_vertex > node) {
+                waitingTails[edge.to_vertex].push_back(node);
+            } else if (edge.to_vertex < node) {
+                lowerHeads.push_back(edge.to_vertex);
+            }
+        }
+        std::sort(lowerHeads.begin(), lowerHeads.end());
+        if (lowerHeads != waitingTails[node]) {
+            return false;
+        }
+        std::vector<int>().swap(waitingTails[node]);
+    }
+    return true;
+}
+
 int Graph::nodeCount() const {
     return static_cast<int>(this->adjacencyList.size());
 }
 
+const std::vector<Edge>& Graph::neighbors(int node) const {
+    return this->adjacencyList[node];
+}
+
+Graph Graph::relabeled(const std::vector<int>& newIds) const {
+    std::vector<std::vector<Edge>> relabeledList(this->nodeCount());
+    for (int node = 0; node < this->nodeCount(); node++) {
+        std::vector<Edge>& neighbors = relabeledList[newIds[node]];
+        neighbors.reserve(this->adjacencyList[node].size());
+        for (const Edge& edge : this->adjacencyList[node]) {
+            neighbors.push_back(Edge(newIds[edge.to_vertex], edge.weight));
+        }
+        std::sort(neighbors.begin(), neighbors.end(), [](const Edge& left, const Edge& right) {
+            return left.to_vertex < right.to_vertex;
+        });
+    }
+    return Graph(std::move(relabeledList));
+}
+
+// FNV-1a over the node count and every (neighbor, weight) pair, with a separator between nodes
+uint64_t Graph::fingerprint() const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int byte = 0; byte < 8; byte++) {
+            hash ^= (value >> (byte * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(this->adjacencyList.size());
+    for (const auto& neighbors : this->adjacencyList) {
+        for (Edge edge : neighbors) {
+            mix(static_cast<uint64_t>(edge.to_vertex));
+            mix(static_cast<uint64_t>(edge.weight));
+        }
+        mix(std::numeric_limits<uint64_t>::max());
+    }
+    return hash;
+}
+
+
+double Graph::expansion(const Subset& subset) const {
+    std::vector<bool> inSubset(this->nodeCount(), false);
+    for (int node : subset) {
+        inSubset[node] = true;
+    }
+    int64_t crossing = 0;
+    for (int node : subset) {
+        for (const Edge& neighbor : this->adjacencyList[node]) {
+            if (!inSubset[neighbor.to_vertex]) {
+                crossing++;
+            }
+        }
+    }
+    int64_t smaller = std::min<int64_t>(subset.size(), this->nodeCount() - subset.size());
+    if (smaller == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return static_cast<double>(crossing) / smaller;
+}
 
 void Graph::addUndirectedEdge(int u, int v, int weight) {
     // SKIP SELF LOOPS
@@ -97,7 +283,7 @@ int Graph::createNode(std::vector<Edge> edges) {
 }
 
 Graph::Graph(std::vector<std::vector<Edge>>&& adjacencyList) {
-    this->adjacencyList = adjacencyList;
+    this->adjacencyList = std::move(adjacencyList);
 }
 
 void Graph::subdivideGraph() {
@@ -9,7 +9,11 @@
 #define Graph_h
 
 #include <vector>
+#include <cstdint>
+#include <istream>
+#include <optional>
 #include <sstream>
+#include <string>
 #include <utility>
 #include <unordered_set>
 
@@ -30,6 +34,11 @@ public:
     // accepts a buffer of an adjacency list, where each line is neighbor,weight,neighbor,weight and so on
     Graph(std::stringstream& buffer);
     explicit Graph(std::vector<std::vector<Edge>>&& adjacencyList);
+    // reads a graph in the binary CSR format from CSRFormat.hpp (written by cmg-gen)
+    static std::optional<Graph> readCSR(std::istream& input);
+    // loads a graph from a Chaco or binary CSR file, telling them apart by the CSR magic
+    // prints the error and returns nothing if the file can't be read, or if it isn't symmetric
+    static std::optional<Graph> load(const std::string& path);
     // Modifies the graph where each edge (u,v) is split into two edges joined by a new node w, resulting in (u,w) and (w,v)
     void subdivideGraph();
     // generate new graph only containing nodes from the subset
@@ -41,6 +50,16 @@ public:
     // output in graphviz DOT format, if subset provided, color them a different color
     void displayDOT(const Subset& subset = {}) const;
     int nodeCount() const;
+    const std::vector<Edge>& neighbors(int node) const;
+    // copy of the graph with node u renamed to newIds[u] (newIds has to be a permutation). Neighbor lists come out sorted
+    Graph relabeled(const std::vector<int>& newIds) const;
+    // hash of the adjacency lists, so we can tell if a saved game belongs to this graph
+    uint64_t fingerprint() const;
+    // whether every edge u -> v is matched by an edge v -> u (as many times, for parallel edges). The flow kernel and the
+    // certificate pair up the two directions of every edge and rely on this. Sets node to the first node whose row doesn't match up
+    bool isSymmetric(int& node) const;
+    // edges leaving subset divided by the size of the smaller side, or infinity if either side is empty
+    double expansion(const Subset& subset) const;
 private:
     std::vector<std::vector<Edge>> adjacencyList;
     // assumes u and v are already nodes in the graph (the adjacencyList.size > u and > v)
@@ -51,6 +70,7 @@ private:
     friend class MaxFlow;
     friend class EdmondsKarpMaxFlow;
     friend class PushRelabelMaxFlow;
+    friend class EmbeddingCertificate;
 };
 
 #endif /* Graph_h */
@@ -0,0 +1,85 @@
+//
+//  GraphCache.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "GraphCache.hpp"
+#include <exception>
+
+GraphCache::GraphCache(size_t capacity) : capacity(std::max<size_t>(capacity, 1)) { }
+
+std::shared_ptr<const LoadedGraph> GraphCache::get(const std::string& path, VertexOrdering ordering, std::ostream& output, bool& hit) {
+    std::error_code error;
+    std::filesystem::file_time_type modified = std::filesystem::last_write_time(path, error);
+    if (error) {
+        // let the loader say what's wrong with the path
+        hit = false;
+        std::optional<LoadedGraph> graph = loadGraph(path, ordering, output);
+        return graph ? std::make_shared<const LoadedGraph>(std::move(*graph)) : nullptr;
+    }
+
+    std::string key = std::string(vertexOrderingName(ordering)) + ":" + path;
+    std::promise<std::shared_ptr<const LoadedGraph>> loading;
+    std::shared_future<std::shared_ptr<const LoadedGraph>> graph;
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto found = this->entries.find(key);
+        if (found != this->entries.end() && found->second.modified == modified) {
+            this->recency.splice(this->recency.begin(), this->recency, found->second.use);
+            hit = true;
+            graph = found->second.graph;
+        } else {
+            if (found != this->entries.end()) {
+                // the file changed since it was parsed
+                this->recency.erase(found->second.use);
+                this->entries.erase(found);
+            }
+            hit = false;
+            graph = loading.get_future().share();
+            id = this->nextId++;
+            this->recency.push_front(key);
+            this->entries.emplace(key, Entry{modified, graph, this->recency.begin(), id});
+            this->evict();
+        }
+    }
+    if (hit) {
+        return graph.get();
+    }
+
+    // parse outside the lock so other graphs can be served meanwhile
+    std::optional<LoadedGraph> loaded;
+    try {
+        loaded = loadGraph(path, ordering, output);
+    } catch (const std::exception& error) {
+        // a malformed file can throw from the parser. Don't leave the waiting requests (or later ones) with a broken promise
+        output << "Error parsing " << path << ": " << error.what() << "\n";
+    }
+    if (!loaded) {
+        loading.set_value(nullptr);
+        this->forget(key, id);
+        return nullptr;
+    }
+    std::shared_ptr<const LoadedGraph> result = std::make_shared<const LoadedGraph>(std::move(*loaded));
+    loading.set_value(result);
+    return result;
+}
+
+void GraphCache::evict() {
+    while (this->entries.size() > this->capacity) {
+        this->entries.erase(this->recency.back());
+        this->recency.pop_back();
+    }
+}
+
+void GraphCache::forget(const std::string& key, uint64_t id) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto found = this->entries.find(key);
+    // it may have been replaced by a newer version of the file in the meantime
+    if (found != this->entries.end() && found->second.id == id) {
+        this->recency.erase(found->second.use);
+        this->entries.erase(found);
+    }
+}
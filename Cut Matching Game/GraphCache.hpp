@@ -0,0 +1,51 @@
+//
+//  GraphCache.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Keeps the most recently used parsed graphs around, keyed by path, vertex ordering and modification time so an edited file is
+// parsed again.
+// Graphs are handed out as shared pointers, so evicting one doesn't pull it out from under a game that's still running on it.
+
+#ifndef GraphCache_hpp
+#define GraphCache_hpp
+
+#include "Reordering.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class GraphCache {
+public:
+    explicit GraphCache(size_t capacity);
+    // returns nothing if the graph can't be loaded. Requests for a graph that's already being parsed wait for that parse
+    // instead of starting another. hit is set to whether the graph was already parsed (or being parsed).
+    // The reordering report (see loadGraph) goes to output when the graph is parsed
+    std::shared_ptr<const LoadedGraph> get(const std::string& path, VertexOrdering ordering, std::ostream& output, bool& hit);
+private:
+    struct Entry {
+        std::filesystem::file_time_type modified;
+        std::shared_future<std::shared_ptr<const LoadedGraph>> graph;
+        // position in recency
+        std::list<std::string>::iterator use;
+        // tells apart entries for the same path
+        uint64_t id;
+    };
+    size_t capacity;
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    // most recently used key first
+    std::list<std::string> recency;
+    uint64_t nextId = 0;
+    void evict();
+    // drops the entry for key if it's still the one with id
+    void forget(const std::string& key, uint64_t id);
+};
+
+#endif /* GraphCache_hpp */
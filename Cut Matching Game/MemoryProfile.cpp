@@ -0,0 +1,237 @@
+//
+//  MemoryProfile.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "MemoryProfile.hpp"
+#include <sys/resource.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace MemoryProfile {
+
+namespace {
+
+std::string formatBytes(int64_t bytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024 && unit < 4) {
+        value /= 1024;
+        unit++;
+    }
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), unit == 0 ? "%.0f %s" : "%.1f %s", value, units[unit]);
+    return buffer;
+}
+
+int64_t peakRSS() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    // bytes on macOS
+    return usage.ru_maxrss;
+#else
+    // kilobytes on Linux
+    return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+}
+
+#ifdef CMG_MEMORY_PROFILE
+
+namespace {
+
+const char* NAMES[SubsystemCount] = {"other", "residual", "vector cache", "projection", "matchings", "cut player", "checkpoint", "certificate"};
+
+// index SubsystemCount holds the total over every subsystem
+std::atomic<int64_t> live[SubsystemCount + 1];
+std::atomic<int64_t> peak[SubsystemCount + 1];
+std::atomic<int64_t> phasePeak[SubsystemCount + 1];
+thread_local Subsystem current = Other;
+
+struct PhaseRecord {
+    const char* name;
+    int64_t peaks[SubsystemCount + 1];
+};
+std::mutex phaseMutex;
+std::vector<PhaseRecord> phasesSinceReport;
+
+void raise(std::atomic<int64_t>& target, int64_t value) {
+    int64_t seen = target.load(std::memory_order_relaxed);
+    while (value > seen && !target.compare_exchange_weak(seen, value, std::memory_order_relaxed)) { }
+}
+
+void charge(int subsystem, int64_t bytes) {
+    int64_t now = live[subsystem].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    raise(peak[subsystem], now);
+    raise(phasePeak[subsystem], now);
+}
+
+// kept in front of every block, 16 bytes so the block stays aligned for anything new has to support
+struct alignas(16) Header {
+    uint64_t size;
+    uint32_t subsystem;
+};
+
+void* allocate(std::size_t size) {
+    void* block = std::malloc(sizeof(Header) + size);
+    if (block == nullptr) {
+        return nullptr;
+    }
+    Header* header = static_cast<Header*>(block);
+    header->size = size;
+    header->subsystem = current;
+    charge(current, static_cast<int64_t>(size));
+    charge(SubsystemCount, static_cast<int64_t>(size));
+    return header + 1;
+}
+
+void release(void* pointer) {
+    if (pointer == nullptr) {
+        return;
+    }
+    Header* header = static_cast<Header*>(pointer) - 1;
+    live[header->subsystem].fetch_sub(static_cast<int64_t>(header->size), std::memory_order_relaxed);
+    live[SubsystemCount].fetch_sub(static_cast<int64_t>(header->size), std::memory_order_relaxed);
+    std::free(header);
+}
+
+}
+
+bool available() {
+    return true;
+}
+
+Scope::Scope(Subsystem subsystem) : previous(current) {
+    current = subsystem;
+}
+
+Scope::~Scope() {
+    current = this->previous;
+}
+
+Phase::Phase(const char* name) : name(name) {
+    for (int subsystem = 0; subsystem <= SubsystemCount; subsystem++) {
+        phasePeak[subsystem].store(live[subsystem].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+Phase::~Phase() {
+    PhaseRecord record;
+    record.name = this->name;
+    for (int subsystem = 0; subsystem <= SubsystemCount; subsystem++) {
+        record.peaks[subsystem] = phasePeak[subsystem].load(std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(phaseMutex);
+    phasesSinceReport.push_back(record);
+}
+
+void reportRound(std::ostream& out, int round) {
+    out << "Memory after round " << round << ": live " << formatBytes(live[SubsystemCount].load()) << " (";
+    bool first = true;
+    for (int subsystem = 0; subsystem < SubsystemCount; subsystem++) {
+        int64_t bytes = live[subsystem].load();
+        if (bytes != 0) {
+            out << (first ? "" : ", ") << NAMES[subsystem] << " " << formatBytes(bytes);
+            first = false;
+        }
+    }
+    out << ")\n";
+
+    std::lock_guard<std::mutex> lock(phaseMutex);
+    for (const PhaseRecord& record : phasesSinceReport) {
+        out << "  " << record.name << " phase peak " << formatBytes(record.peaks[SubsystemCount]) << " (";
+        first = true;
+        for (int subsystem = 0; subsystem < SubsystemCount; subsystem++) {
+            if (record.peaks[subsystem] != 0) {
+                out << (first ? "" : ", ") << NAMES[subsystem] << " " << formatBytes(record.peaks[subsystem]);
+                first = false;
+            }
+        }
+        out << ")\n";
+    }
+    phasesSinceReport.clear();
+}
+
+void reportSummary(std::ostream& out) {
+    out << "Memory summary (peak heap bytes per subsystem):\n";
+    for (int subsystem = 0; subsystem < SubsystemCount; subsystem++) {
+        out << "  " << NAMES[subsystem] << ": " << formatBytes(peak[subsystem].load()) << "\n";
+    }
+    out << "  total heap peak: " << formatBytes(peak[SubsystemCount].load()) << "\n";
+    out << "  peak RSS: " << formatBytes(peakRSS()) << "\n";
+}
+
+#else
+
+bool available() {
+    return false;
+}
+
+void reportRound(std::ostream&, int) { }
+
+void reportSummary(std::ostream& out) {
+    out << "Peak RSS: " << formatBytes(peakRSS()) << " (build with -DCMG_MEMORY_PROFILE for a breakdown)\n";
+}
+
+#endif
+
+}
+
+#ifdef CMG_MEMORY_PROFILE
+
+void* operator new(std::size_t size) {
+    void* pointer = MemoryProfile::allocate(size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return MemoryProfile::allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return MemoryProfile::allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    MemoryProfile::release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    MemoryProfile::release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    MemoryProfile::release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    MemoryProfile::release(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    MemoryProfile::release(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    MemoryProfile::release(pointer);
+}
+
+#endif
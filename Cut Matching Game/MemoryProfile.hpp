@@ -0,0 +1,79 @@
+//
+//  MemoryProfile.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Counts live and peak heap bytes per subsystem by replacing the global operator new/delete.
+// Only compiled in with -DCMG_MEMORY_PROFILE (e.g. `scripts/build.sh -DCMG_MEMORY_PROFILE`), otherwise Scope and Phase are empty
+// and nothing is hooked, so normal builds pay nothing for it.
+// Allocations are charged to whatever Scope is innermost on the allocating thread, and frees go back to the subsystem that allocated.
+
+#ifndef MemoryProfile_hpp
+#define MemoryProfile_hpp
+
+#include <ostream>
+
+namespace MemoryProfile {
+
+enum Subsystem {
+    Other,
+    // the flow kernel's residual graph and the rest of the max flow's working memory
+    Residual,
+    // randomVectorCache and the potential probes
+    VectorCache,
+    // fresh random vectors and their projections
+    Projection,
+    // the matchings played so far
+    Matchings,
+    // pairedPosVector and the cut itself
+    CutPlayer,
+    Checkpoint,
+    Certificate,
+    SubsystemCount,
+};
+
+// true if the allocation hooks were compiled in
+bool available();
+
+#ifdef CMG_MEMORY_PROFILE
+class Scope {
+public:
+    explicit Scope(Subsystem subsystem);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+private:
+    Subsystem previous;
+};
+
+// tracks the peak of every subsystem between its construction and destruction, reported with the round
+class Phase {
+public:
+    explicit Phase(const char* name);
+    ~Phase();
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+private:
+    const char* name;
+};
+#else
+class Scope {
+public:
+    explicit Scope(Subsystem) { }
+};
+
+class Phase {
+public:
+    explicit Phase(const char*) { }
+};
+#endif
+
+// prints live bytes per subsystem and the peak of every phase since the last report
+void reportRound(std::ostream& out, int round);
+// prints the peak of every subsystem over the whole run, and the process's peak RSS
+void reportSummary(std::ostream& out);
+
+}
+
+#endif /* MemoryProfile_hpp */
@@ -0,0 +1,117 @@
+//
+//  PhiSearch.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "PhiSearch.hpp"
+#include "MemoryProfile.hpp"
+#include "Reordering.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+PhiSearch::PhiSearch(const Graph& graph, const GameOptions& options, int maxPhiInverse, std::string witnessPath) : graph(graph), options(options), maxPhiInverse(maxPhiInverse), witnessPath(std::move(witnessPath)), output(*options.output) {
+    if (!this->options.seed) {
+        this->options.seed = std::random_device()();
+    }
+    // the graph is the same for every probe, so only the residual capacities are new for each one
+    if (!this->options.flowLayout) {
+        MemoryProfile::Scope scope(MemoryProfile::Residual);
+        this->options.flowLayout = std::make_shared<const FlowLayout>(graph);
+    }
+}
+
+std::optional<bool> PhiSearch::probe(int phiInverse) {
+    this->output << "Probing phiInverse " << phiInverse << "\n";
+    GameOptions probeOptions = this->options;
+    probeOptions.phiInverse = phiInverse;
+    Game game(this->graph, 0, this->graph.nodeCount(), probeOptions);
+    std::optional<GameResult> played = game.run();
+    if (!played) {
+        return std::nullopt;
+    }
+    this->result.probes++;
+    this->result.totalRounds += played->rounds;
+
+    if (!played->foundCut) {
+        this->result.expanderPhiInverse = phiInverse;
+        return false;
+    }
+    this->result.cutPhiInverse = std::max(this->result.cutPhiInverse, phiInverse);
+    double expansion = this->graph.expansion(played->witness);
+    if (this->result.witness.empty() || expansion < this->result.witnessExpansion) {
+        this->result.witness = std::move(played->witness);
+        this->result.witnessExpansion = expansion;
+    }
+    // the witness rules out being a 1/k expander for every k < 1/expansion. Expansion 0 (a witness with no edges leaving it, as
+    // screening finds in a disconnected graph) rules out every k, and nothing past the limit is searched either way
+    double bound = this->result.witnessExpansion > 0 ? std::ceil(1 / this->result.witnessExpansion) - 1 : this->maxPhiInverse;
+    int implied = static_cast<int>(std::min<double>(bound, this->maxPhiInverse));
+    if (implied > this->result.cutPhiInverse) {
+        this->result.cutPhiInverse = implied;
+        this->output << "Witness has expansion " << this->result.witnessExpansion << ", so there are cuts up to phiInverse " << implied << "\n";
+    }
+    return true;
+}
+
+std::optional<PhiSearchResult> PhiSearch::run() {
+    // gallop up until some probe certifies an expander
+    // 64 bits, since doubling past the largest int is how the gallop ends near it
+    int64_t next = this->options.phiInverse;
+    while (this->result.expanderPhiInverse == 0 && next <= this->maxPhiInverse) {
+        if (!this->probe(static_cast<int>(next))) {
+            return std::nullopt;
+        }
+        next = std::max<int64_t>(2 * next, static_cast<int64_t>(this->result.cutPhiInverse) + 1);
+    }
+    if (this->result.expanderPhiInverse == 0 && this->result.cutPhiInverse < this->maxPhiInverse) {
+        // one last probe at the limit, since doubling can step over it
+        if (!this->probe(this->maxPhiInverse)) {
+            return std::nullopt;
+        }
+    }
+
+    // then binary search the gap between the last cut and the first expander
+    while (this->result.expanderPhiInverse != 0 && this->result.expanderPhiInverse - this->result.cutPhiInverse > 1) {
+        int middle = this->result.cutPhiInverse + (this->result.expanderPhiInverse - this->result.cutPhiInverse) / 2;
+        if (!this->probe(middle)) {
+            return std::nullopt;
+        }
+    }
+    // the game's expander answer only holds up to log factors, so a witness can reach past it. Keep the interval consistent
+    if (this->result.expanderPhiInverse != 0) {
+        this->result.cutPhiInverse = std::min(this->result.cutPhiInverse, this->result.expanderPhiInverse - 1);
+    }
+
+    if (this->result.expanderPhiInverse == 0) {
+        this->output << "No expander certified up to phiInverse " << this->maxPhiInverse << "\n";
+    } else if (this->result.cutPhiInverse == 0) {
+        this->output << "Certified a 1/" << this->result.expanderPhiInverse << " expander, and found no cut\n";
+    } else {
+        this->output << "Threshold is between phiInverse " << this->result.cutPhiInverse << " (cut) and " << this->result.expanderPhiInverse << " (expander)\n";
+    }
+    if (!this->result.witness.empty()) {
+        this->output << "Sparsest witness has " << this->result.witness.size() << " nodes and expansion " << this->result.witnessExpansion << "\n";
+        if (!this->witnessPath.empty() && this->writeWitness()) {
+            this->output << "Wrote witness to " << this->witnessPath << "\n";
+        }
+    }
+    this->output << "Search took " << this->result.probes << " probes and " << this->result.totalRounds << " rounds in total\n";
+    return this->result;
+}
+
+bool PhiSearch::writeWitness() const {
+    std::ofstream file(this->witnessPath, std::ios::trunc);
+    if (!file.is_open()) {
+        *this->options.errors << "Error opening witness (" << this->witnessPath << ") for writing\n";
+        return false;
+    }
+    const VertexOrder* order = this->options.vertexOrder;
+    for (int node : this->result.witness) {
+        file << (order ? order->originalIds[node] : node) + 1 << "\n";
+    }
+    return true;
+}
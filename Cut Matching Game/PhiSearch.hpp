@@ -0,0 +1,53 @@
+//
+//  PhiSearch.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Searches phiInverse for the point where the game stops finding cuts, instead of running cmg once per value.
+// Gallops up from the starting phiInverse until the game certifies an expander, then binary searches the gap. Every probe plays on
+// the same loaded graph with the same seed, so they all start from the same random vectors.
+// Finding a cut at 1/k means the graph has a sparse cut, and finding none means more capacity won't find one either, so the answers
+// are monotone in phiInverse. On top of that, each cut found is a witness: its expansion psi shows the graph isn't a 1/k' expander
+// for any k' < 1/psi, so those probes are skipped.
+
+#ifndef PhiSearch_hpp
+#define PhiSearch_hpp
+
+#include "Game.hpp"
+#include <ostream>
+#include <string>
+
+struct PhiSearchResult {
+    // largest phiInverse known to have a cut (found by a probe or implied by the witness), 0 if there's none
+    int cutPhiInverse = 0;
+    // smallest phiInverse the game certified an expander for, 0 if it never did up to the limit
+    int expanderPhiInverse = 0;
+    // the sparsest cut found by any probe, and its expansion
+    Subset witness;
+    double witnessExpansion = 0;
+    int probes = 0;
+    // rounds played over every probe
+    int totalRounds = 0;
+};
+
+class PhiSearch {
+public:
+    // searches from options.phiInverse up to maxPhiInverse, with the rest of options used for every probe.
+    // If witnessPath is set, the sparsest witness is written there (1-indexed node ids, one per line)
+    PhiSearch(const Graph& graph, const GameOptions& options, int maxPhiInverse, std::string witnessPath);
+    // returns nothing if a probe couldn't be played
+    std::optional<PhiSearchResult> run();
+private:
+    const Graph& graph;
+    GameOptions options;
+    const int maxPhiInverse;
+    const std::string witnessPath;
+    std::ostream& output;
+    PhiSearchResult result;
+    // plays the game at phiInverse and narrows the result with it. Returns whether it found a cut
+    std::optional<bool> probe(int phiInverse);
+    bool writeWitness() const;
+};
+
+#endif /* PhiSearch_hpp */
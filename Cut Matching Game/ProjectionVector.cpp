@@ -0,0 +1,154 @@
+//
+//  ProjectionVector.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "ProjectionVector.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+
+namespace {
+
+const char* NAMES[] = {"double", "float", "fixed"};
+
+// the largest fixed point value is kept in [2^29, 2^30], leaving a bit spare so sums of two don't need care beyond int64
+const int64_t FIXED_TOP = int64_t(1) << 30;
+const int64_t FIXED_FLOOR = int64_t(1) << 29;
+// finding the largest value is a pass over the whole vector, as much work as a matching, so it's only done every few matchings.
+// Values shrink by a few bits per matching at most in practice, which the 30 bits of scale have room for
+const int RENORMALIZE_INTERVAL = 4;
+
+double mean(const std::vector<double>& values) {
+    double sum = 0;
+    for (double value : values) {
+        sum += value;
+    }
+    return values.empty() ? 0 : sum / values.size();
+}
+
+}
+
+std::optional<VectorPrecision> parseVectorPrecision(const std::string& name) {
+    for (int precision = 0; precision < static_cast<int>(std::size(NAMES)); precision++) {
+        if (name == NAMES[precision]) {
+            return static_cast<VectorPrecision>(precision);
+        }
+    }
+    return std::nullopt;
+}
+
+const char* vectorPrecisionName(VectorPrecision precision) {
+    return NAMES[static_cast<int>(precision)];
+}
+
+ProjectionVector::ProjectionVector(const std::vector<double>& values, VectorPrecision precision, bool keepReference) : precision(precision) {
+    if (keepReference) {
+        double center = mean(values);
+        this->reference.reserve(values.size());
+        for (double value : values) {
+            this->reference.push_back(value - center);
+            this->referenceScale = std::max(this->referenceScale, std::abs(value - center));
+        }
+    }
+    switch (precision) {
+        case VectorPrecision::Double:
+            this->doubles = values;
+            break;
+        case VectorPrecision::Float: {
+            double center = mean(values);
+            this->floats.reserve(values.size());
+            for (double value : values) {
+                this->floats.push_back(static_cast<float>(value - center));
+            }
+            break;
+        }
+        case VectorPrecision::Fixed: {
+            double center = mean(values);
+            double largest = 0;
+            for (double value : values) {
+                largest = std::max(largest, std::abs(value - center));
+            }
+            double scale = largest > 0 ? FIXED_TOP / largest : 1;
+            this->fixed.reserve(values.size());
+            for (double value : values) {
+                this->fixed.push_back(static_cast<int32_t>(std::llround((value - center) * scale)));
+            }
+            break;
+        }
+    }
+}
+
+void ProjectionVector::applyMatching(const Matching& match, int firstActiveNode) {
+    switch (this->precision) {
+        case VectorPrecision::Double:
+            averageAlongMatching(this->doubles, match, firstActiveNode);
+            break;
+        case VectorPrecision::Float:
+            averageAlongMatching(this->floats, match, firstActiveNode);
+            break;
+        case VectorPrecision::Fixed:
+            averageAlongMatching(this->fixed, match, firstActiveNode);
+            if (++this->matchingsSinceRenormalize >= RENORMALIZE_INTERVAL) {
+                this->matchingsSinceRenormalize = 0;
+                this->renormalize();
+            }
+            break;
+    }
+    if (!this->reference.empty()) {
+        averageAlongMatching(this->reference, match, firstActiveNode);
+        this->referenceMatchings++;
+    }
+}
+
+void ProjectionVector::renormalize() {
+    int64_t largest = 0;
+    for (int32_t value : this->fixed) {
+        largest = std::max(largest, std::abs(static_cast<int64_t>(value)));
+    }
+    if (largest == 0 || largest >= FIXED_FLOOR) {
+        return;
+    }
+    int shift = 0;
+    while ((largest << (shift + 1)) <= FIXED_TOP) {
+        shift++;
+    }
+    for (int32_t& value : this->fixed) {
+        // scaling every value by the same power of two keeps their order
+        value = static_cast<int32_t>(static_cast<int64_t>(value) * (int64_t(1) << shift));
+    }
+}
+
+Cut ProjectionVector::splitAtMedian(int firstActiveNode) const {
+    switch (this->precision) {
+        case VectorPrecision::Double:
+            return ::splitAtMedian(this->doubles, firstActiveNode);
+        case VectorPrecision::Float:
+            return ::splitAtMedian(this->floats, firstActiveNode);
+        case VectorPrecision::Fixed:
+            return ::splitAtMedian(this->fixed, firstActiveNode);
+    }
+    return {};
+}
+
+bool ProjectionVector::hasReference() const {
+    return !this->reference.empty();
+}
+
+Cut ProjectionVector::splitReferenceAtMedian(int firstActiveNode) const {
+    return ::splitAtMedian(this->reference, firstActiveNode);
+}
+
+bool ProjectionVector::referenceAboveRoundingFloor() const {
+    // every average rounds off at most an epsilon of the largest starting value, and averaging doesn't grow the errors already there
+    double drift = this->referenceMatchings * std::numeric_limits<double>::epsilon() * this->referenceScale;
+    double largest = 0;
+    for (double value : this->reference) {
+        largest = std::max(largest, std::abs(value));
+    }
+    // neighboring values around the median are about largest / n apart
+    return largest / this->reference.size() > drift;
+}
@@ -0,0 +1,123 @@
+//
+//  ProjectionVector.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// A random vector as the cut player projects it through the matchings, kept in double, float or 32 bit fixed point.
+// The cut only depends on the order of the values, so float and fixed point store each value's distance from the vector's mean
+// (which exact averaging along matchings never changes, and fixed point's rounding down only moves by half a unit per pair with an
+// odd sum). That spends their precision on what tells nodes apart instead of on the mean.
+// Fixed point is scaled so the largest distance is close to 2^30, and every few matchings scaled back up if the matchings have shrunk
+// it by half.
+
+#ifndef ProjectionVector_hpp
+#define ProjectionVector_hpp
+
+#include "Graph.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+enum class VectorPrecision {
+    Double,
+    Float,
+    Fixed,
+};
+
+std::optional<VectorPrecision> parseVectorPrecision(const std::string& name);
+const char* vectorPrecisionName(VectorPrecision precision);
+
+// sets both nodes of every pair to their average. values are indexed by node - firstActiveNode
+template <typename T>
+void averageAlongMatching(std::vector<T>& values, const Matching& match, int firstActiveNode) {
+    for (auto& pair : match) {
+        int shiftedFirst = pair.first - firstActiveNode;
+        int shiftedSecond = pair.second - firstActiveNode;
+        // assert that all matchings are between split nodes
+        assert(0 <= shiftedFirst && shiftedFirst < static_cast<int>(values.size()));
+        assert(0 <= shiftedSecond && shiftedSecond < static_cast<int>(values.size()));
+        T avg;
+        if constexpr (std::is_integral_v<T>) {
+            // the sum of two 32 bit values can overflow
+            avg = static_cast<T>((static_cast<int64_t>(values[shiftedFirst]) + values[shiftedSecond]) >> 1);
+        } else {
+            avg = (values[shiftedFirst] + values[shiftedSecond]) / 2;
+        }
+        values[shiftedFirst] = avg;
+        values[shiftedSecond] = avg;
+    }
+}
+
+// splits the active nodes at the median of values, lower half first. Returns graph ids
+template <typename T>
+Cut splitAtMedian(const std::vector<T>& values, int firstActiveNode) {
+    int activeNodeCount = static_cast<int>(values.size());
+    // so we can keep track of position and node when we find median
+    std::vector<std::pair<T, int>> pairedPosVector;
+    pairedPosVector.reserve(values.size());
+    
+    int index = 0;
+    for (T pos : values) {
+        pairedPosVector.push_back({pos, index});
+        index++;
+    }
+    
+    auto compare = [](const std::pair<T, int>& left, const std::pair<T, int>& right) {
+        return left.first < right.first;
+    };
+    
+    auto median = pairedPosVector.begin() + activeNodeCount / 2;
+    
+    // rearranges the array in O(n) time to get everything below the median in the first half of the array and everything equal to or above in the second half
+    std::nth_element(pairedPosVector.begin(), median, pairedPosVector.end(), compare);
+    
+    Subset cut, notCut;
+    cut.reserve(activeNodeCount / 2);
+    // in case its odd
+    notCut.reserve((activeNodeCount / 2) + 1);
+    
+    for (auto it = pairedPosVector.begin(); it != pairedPosVector.end(); it++) {
+        if (it < median) {
+            cut.push_back(it->second + firstActiveNode);
+        } else {
+            notCut.push_back(it->second + firstActiveNode);
+        }
+    }
+    
+    return {cut, notCut};
+}
+
+class ProjectionVector {
+public:
+    ProjectionVector() = default;
+    // if keepReference is set, an exact double copy is updated alongside so the cuts can be checked against it
+    ProjectionVector(const std::vector<double>& values, VectorPrecision precision, bool keepReference);
+    void applyMatching(const Matching& match, int firstActiveNode);
+    Cut splitAtMedian(int firstActiveNode) const;
+    bool hasReference() const;
+    // the cut the exact values would give
+    Cut splitReferenceAtMedian(int firstActiveNode) const;
+    // whether the exact values are still far enough apart that their own rounding doesn't decide the cut. Once the matchings have
+    // mixed a vector that far, no precision tells its nodes apart, so there's nothing left to check
+    bool referenceAboveRoundingFloor() const;
+private:
+    VectorPrecision precision = VectorPrecision::Double;
+    // only the one for precision is used
+    std::vector<double> doubles;
+    std::vector<float> floats;
+    std::vector<int32_t> fixed;
+    std::vector<double> reference;
+    // the reference's largest starting value, and the matchings averaged into it since
+    double referenceScale = 0;
+    int referenceMatchings = 0;
+    int matchingsSinceRenormalize = 0;
+    // scales the fixed point values back up if averaging has shrunk them
+    void renormalize();
+};
+
+#endif /* ProjectionVector_hpp */
@@ -10,6 +10,7 @@
 
 #include "PushRelabelMaxFlow.hpp"
 #include <cassert>
+#include <limits>
 
 PushRelabelMaxFlow::PushRelabelMaxFlow(const Graph& graph, int source, int sink, int targetFlow, int phiInverse) : MaxFlow(graph, source, sink, targetFlow, phiInverse) { }
 
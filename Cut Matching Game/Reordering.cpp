@@ -0,0 +1,174 @@
+//
+//  Reordering.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "Reordering.hpp"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace {
+
+const char* NAMES[] = {"input", "bfs", "rcm", "degree"};
+
+using Clock = std::chrono::steady_clock;
+
+// more than any last level cache, so streaming through it leaves none of the graph cached
+const size_t CACHE_EVICTION_BYTES = 64 << 20;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// BFS order over every component, starting each component at the first unvisited node in start order and visiting neighbors
+// sorted by degree if byDegree is set. Returns nodes in the order they were visited
+std::vector<int> breadthFirstOrder(const Graph& graph, const std::vector<int>& starts, bool byDegree) {
+    int nodes = graph.nodeCount();
+    std::vector<int> visited;
+    visited.reserve(nodes);
+    std::vector<bool> seen(nodes, false);
+    std::vector<int> next;
+    for (int start : starts) {
+        if (seen[start]) {
+            continue;
+        }
+        seen[start] = true;
+        visited.push_back(start);
+        for (size_t head = visited.size() - 1; head < visited.size(); head++) {
+            next.clear();
+            for (const Edge& edge : graph.neighbors(visited[head])) {
+                if (!seen[edge.to_vertex]) {
+                    seen[edge.to_vertex] = true;
+                    next.push_back(edge.to_vertex);
+                }
+            }
+            if (byDegree) {
+                std::stable_sort(next.begin(), next.end(), [&graph](int left, int right) {
+                    return graph.neighbors(left).size() < graph.neighbors(right).size();
+                });
+            }
+            visited.insert(visited.end(), next.begin(), next.end());
+        }
+    }
+    return visited;
+}
+
+// sum of |u - v| over every edge divided by the edge count, how far apart neighbors sit in memory on average
+double averageEdgeSpan(const Graph& graph) {
+    double span = 0;
+    int64_t arcs = 0;
+    for (int node = 0; node < graph.nodeCount(); node++) {
+        for (const Edge& edge : graph.neighbors(node)) {
+            span += std::abs(edge.to_vertex - node);
+            arcs++;
+        }
+    }
+    return arcs == 0 ? 0 : span / arcs;
+}
+
+// pushes the graph out of the caches, so neither order gets timed warm off the other's run (or the relabeling)
+void evictCaches() {
+    std::vector<char> eviction(CACHE_EVICTION_BYTES, 1);
+    volatile char sum = 0;
+    for (size_t index = 0; index < eviction.size(); index += 64) {
+        sum = sum + eviction[index];
+    }
+}
+
+// the access pattern of the max flow's BFS, from every node that's still unvisited. Only a proxy for the game's speedup, which
+// also depends on how often the flow revisits the graph while it's still cached
+double timeBreadthFirstSweep(const Graph& graph) {
+    std::vector<int> starts(graph.nodeCount());
+    std::iota(starts.begin(), starts.end(), 0);
+    evictCaches();
+    Clock::time_point start = Clock::now();
+    std::vector<int> visited = breadthFirstOrder(graph, starts, false);
+    double elapsed = millisecondsSince(start);
+    // keep the sweep from being optimized away
+    volatile int last = visited.empty() ? 0 : visited.back();
+    (void)last;
+    return elapsed;
+}
+
+}
+
+std::optional<VertexOrdering> parseVertexOrdering(const std::string& name) {
+    for (int ordering = 0; ordering < static_cast<int>(std::size(NAMES)); ordering++) {
+        if (name == NAMES[ordering]) {
+            return static_cast<VertexOrdering>(ordering);
+        }
+    }
+    return std::nullopt;
+}
+
+const char* vertexOrderingName(VertexOrdering ordering) {
+    return NAMES[static_cast<int>(ordering)];
+}
+
+std::vector<int> computeVertexOrder(const Graph& graph, VertexOrdering ordering) {
+    int nodes = graph.nodeCount();
+    std::vector<int> byId(nodes);
+    std::iota(byId.begin(), byId.end(), 0);
+
+    std::vector<int> visited;
+    switch (ordering) {
+        case VertexOrdering::Input:
+            visited = byId;
+            break;
+        case VertexOrdering::BFS:
+            visited = breadthFirstOrder(graph, byId, false);
+            break;
+        case VertexOrdering::RCM: {
+            // starting every component at its lowest degree node approximates starting at a peripheral node
+            std::vector<int> starts = byId;
+            std::stable_sort(starts.begin(), starts.end(), [&graph](int left, int right) {
+                return graph.neighbors(left).size() < graph.neighbors(right).size();
+            });
+            visited = breadthFirstOrder(graph, starts, true);
+            std::reverse(visited.begin(), visited.end());
+            break;
+        }
+        case VertexOrdering::Degree:
+            visited = byId;
+            std::stable_sort(visited.begin(), visited.end(), [&graph](int left, int right) {
+                return graph.neighbors(left).size() > graph.neighbors(right).size();
+            });
+            break;
+    }
+
+    std::vector<int> newIds(nodes);
+    for (int position = 0; position < nodes; position++) {
+        newIds[visited[position]] = position;
+    }
+    return newIds;
+}
+
+std::optional<LoadedGraph> loadGraph(const std::string& path, VertexOrdering ordering, std::ostream& output) {
+    std::optional<Graph> graph = Graph::load(path);
+    if (!graph) {
+        return std::nullopt;
+    }
+    if (ordering == VertexOrdering::Input) {
+        return LoadedGraph{std::move(*graph), std::nullopt};
+    }
+
+    Clock::time_point start = Clock::now();
+    std::vector<int> newIds = computeVertexOrder(*graph, ordering);
+    Graph relabeled = graph->relabeled(newIds);
+    double cost = millisecondsSince(start);
+
+    VertexOrder order;
+    order.originalFingerprint = graph->fingerprint();
+    order.originalIds.resize(newIds.size());
+    for (size_t node = 0; node < newIds.size(); node++) {
+        order.originalIds[newIds[node]] = static_cast<int>(node);
+    }
+
+    double before = timeBreadthFirstSweep(*graph);
+    double after = timeBreadthFirstSweep(relabeled);
+    output << "Reordered " << path << " by " << vertexOrderingName(ordering) << " in " << cost << " ms. Average edge span " << averageEdgeSpan(*graph) << " -> " << averageEdgeSpan(relabeled) << ", cold cache BFS sweep (a proxy for the max flow) " << before << " ms -> " << after << " ms (" << (after > 0 ? before / after : 1) << "x)\n";
+    return LoadedGraph{std::move(relabeled), std::move(order)};
+}
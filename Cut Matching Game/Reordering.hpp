@@ -0,0 +1,57 @@
+//
+//  Reordering.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Optional relabeling of a graph's nodes after loading, so nodes that are close in the graph are close in memory too. Input files
+// number nodes however their producer did, which leaves the max flow's BFS and the matching updates jumping all over memory.
+// The game is played on the relabeled graph, and the permutation is kept so anything written out uses the input's ids.
+
+#ifndef Reordering_hpp
+#define Reordering_hpp
+
+#include "Graph.hpp"
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class VertexOrdering {
+    // keep the input's ids
+    Input,
+    // breadth first search order, one component after another
+    BFS,
+    // reverse Cuthill-McKee: BFS from a low degree node visiting lower degree neighbors first, then reversed. Keeps the
+    // bandwidth of the adjacency matrix small
+    RCM,
+    // highest degree first, so the hubs most paths go through share cache lines
+    Degree,
+};
+
+std::optional<VertexOrdering> parseVertexOrdering(const std::string& name);
+const char* vertexOrderingName(VertexOrdering ordering);
+
+// newIds[node] is node's position in the ordering
+std::vector<int> computeVertexOrder(const Graph& graph, VertexOrdering ordering);
+
+struct VertexOrder {
+    // originalIds[node] is the input's id for node in the relabeled graph
+    std::vector<int> originalIds;
+    // fingerprint of the graph as it was loaded, so certificates name the input graph
+    uint64_t originalFingerprint;
+};
+
+// a graph as the game sees it
+struct LoadedGraph {
+    Graph graph;
+    // set if the nodes were relabeled
+    std::optional<VertexOrder> order;
+};
+
+// loads the graph at path and relabels it with ordering, printing what the relabeling cost and how much faster a BFS sweep
+// over the graph got to output. Returns nothing if the graph can't be loaded
+std::optional<LoadedGraph> loadGraph(const std::string& path, VertexOrdering ordering, std::ostream& output);
+
+#endif /* Reordering_hpp */
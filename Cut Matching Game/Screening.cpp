@@ -0,0 +1,315 @@
+//
+//  Screening.cpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "Screening.hpp"
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// how many BFS sweeps to try. Each starts from the last node the previous one reached, so they start far apart
+const int BFS_SWEEPS = 4;
+// the labels only need to be unlikely to collide, not unpredictable, and a fixed seed keeps the screening reproducible
+const uint64_t LABEL_SEED = 0x5eed5eed;
+
+// a cut, by how many edges cross it and the size of its smaller side
+struct Candidate {
+    int64_t cutEdges = 0;
+    int64_t balance = 0;
+
+    // sparser than other? Compared as fractions so ties stay ties
+    bool sparserThan(const Candidate& other) const {
+        if (other.balance == 0) {
+            return this->balance > 0;
+        }
+        return this->cutEdges * other.balance < other.cutEdges * this->balance;
+    }
+};
+
+struct SpanningForest {
+    std::vector<int> parent;
+    // preorder of every node. The subtree of node is preorder[pre[node]] .. preorder[pre[node] + subtreeSize[node]]
+    std::vector<int> preorder;
+    std::vector<int> pre;
+    std::vector<int> subtreeSize;
+    // XOR of the labels of the non-tree edges crossing the edge from node up to its parent
+    std::vector<uint64_t> label;
+    std::unordered_set<uint64_t> nonTreeLabels;
+    // root of each component, in the order they were found
+    std::vector<int> roots;
+};
+
+// DFS forest of the graph, with every non-tree edge labeled at random. In a DFS tree every non-tree edge goes from a node to one of
+// its ancestors, so the tree edges sharing a label all lie on one path from the root
+SpanningForest buildForest(const Graph& graph) {
+    int nodeCount = graph.nodeCount();
+    SpanningForest forest;
+    forest.parent.assign(nodeCount, -1);
+    forest.pre.assign(nodeCount, -1);
+    forest.subtreeSize.assign(nodeCount, 1);
+    forest.label.assign(nodeCount, 0);
+    forest.preorder.reserve(nodeCount);
+
+    // the arc a node was discovered along has to be skipped when labeling, but only once in case of parallel edges
+    std::vector<bool> skippedParentArc(nodeCount, false);
+    std::vector<std::pair<int, size_t>> stack;
+    for (int root = 0; root < nodeCount; root++) {
+        if (forest.pre[root] != -1) {
+            continue;
+        }
+        forest.roots.push_back(root);
+        forest.pre[root] = static_cast<int>(forest.preorder.size());
+        forest.preorder.push_back(root);
+        stack.push_back({root, 0});
+        while (!stack.empty()) {
+            auto& [node, arc] = stack.back();
+            const auto& neighbors = graph.neighbors(node);
+            if (arc == neighbors.size()) {
+                int parent = forest.parent[node];
+                if (parent != -1) {
+                    forest.subtreeSize[parent] += forest.subtreeSize[node];
+                }
+                stack.pop_back();
+                continue;
+            }
+            int next = neighbors[arc++].to_vertex;
+            if (forest.pre[next] == -1) {
+                forest.parent[next] = node;
+                forest.pre[next] = static_cast<int>(forest.preorder.size());
+                forest.preorder.push_back(next);
+                stack.push_back({next, 0});
+            }
+        }
+    }
+
+    // every non-tree edge gets a label, XORed into both of its ends. Edges are visited from their lower end
+    std::mt19937_64 gen(LABEL_SEED);
+    std::vector<uint64_t> incident(nodeCount, 0);
+    for (int node = 0; node < nodeCount; node++) {
+        for (const Edge& edge : graph.neighbors(node)) {
+            int next = edge.to_vertex;
+            if (next <= node) {
+                continue;
+            }
+            if (forest.parent[next] == node && !skippedParentArc[next]) {
+                skippedParentArc[next] = true;
+                continue;
+            }
+            if (forest.parent[node] == next && !skippedParentArc[node]) {
+                skippedParentArc[node] = true;
+                continue;
+            }
+            uint64_t label = gen();
+            incident[node] ^= label;
+            incident[next] ^= label;
+            forest.nonTreeLabels.insert(label);
+        }
+    }
+    // the edges crossing the edge above a node are the ones with exactly one end in its subtree
+    for (int index = nodeCount - 1; index >= 0; index--) {
+        int node = forest.preorder[index];
+        forest.label[node] ^= incident[node];
+        if (forest.parent[node] != -1) {
+            forest.label[forest.parent[node]] ^= forest.label[node];
+        }
+    }
+    return forest;
+}
+
+// the sparsest nonempty proper prefix of order, as its length
+std::pair<int, Candidate> bestPrefix(const Graph& graph, const std::vector<int>& order) {
+    int nodeCount = graph.nodeCount();
+    std::vector<bool> inPrefix(nodeCount, false);
+    int64_t cutEdges = 0;
+    int bestLength = 0;
+    Candidate best;
+    for (int length = 1; length < nodeCount; length++) {
+        int node = order[length - 1];
+        inPrefix[node] = true;
+        for (const Edge& edge : graph.neighbors(node)) {
+            if (edge.to_vertex == node) {
+                continue;
+            }
+            cutEdges += inPrefix[edge.to_vertex] ? -1 : 1;
+        }
+        Candidate candidate{cutEdges, std::min(length, nodeCount - length)};
+        if (bestLength == 0 || candidate.sparserThan(best)) {
+            best = candidate;
+            bestLength = length;
+        }
+    }
+    return {bestLength, best};
+}
+
+std::vector<int> bfsOrder(const Graph& graph, int start) {
+    std::vector<bool> visited(graph.nodeCount(), false);
+    std::vector<int> order = {start};
+    visited[start] = true;
+    for (size_t next = 0; next < order.size(); next++) {
+        for (const Edge& edge : graph.neighbors(order[next])) {
+            if (!visited[edge.to_vertex]) {
+                visited[edge.to_vertex] = true;
+                order.push_back(edge.to_vertex);
+            }
+        }
+    }
+    return order;
+}
+
+int64_t countCutEdges(const Graph& graph, const Subset& side) {
+    std::vector<bool> inSide(graph.nodeCount(), false);
+    for (int node : side) {
+        inSide[node] = true;
+    }
+    int64_t cutEdges = 0;
+    for (int node : side) {
+        for (const Edge& edge : graph.neighbors(node)) {
+            cutEdges += !inSide[edge.to_vertex];
+        }
+    }
+    return cutEdges;
+}
+
+}
+
+bool ScreeningResult::sparserThan(int phiInverse) const {
+    return this->cutEdges * phiInverse < this->smallerSide;
+}
+
+std::optional<ScreeningResult> screenForSparseCut(const Graph& graph) {
+    int nodeCount = graph.nodeCount();
+    if (nodeCount < 2) {
+        return std::nullopt;
+    }
+    SpanningForest forest = buildForest(graph);
+
+    ScreeningResult result;
+    if (forest.roots.size() > 1) {
+        // the smallest component has nothing leaving it
+        int smallest = forest.roots[0];
+        for (int root : forest.roots) {
+            if (forest.subtreeSize[root] < forest.subtreeSize[smallest]) {
+                smallest = root;
+            }
+        }
+        auto start = forest.preorder.begin() + forest.pre[smallest];
+        result.kind = "component";
+        result.side.assign(start, start + forest.subtreeSize[smallest]);
+    } else {
+        Candidate best;
+        // the cut is either the subtree below treeEdges.first, minus the subtree below treeEdges.second if that's set,
+        // or the prefix of sweepOrder
+        std::pair<int, int> treeEdges = {-1, -1};
+        std::vector<int> sweepOrder;
+        int sweepLength = 0;
+        auto consider = [&](const char* kind, Candidate candidate) {
+            if (candidate.balance > 0 && (best.balance == 0 || candidate.sparserThan(best))) {
+                best = candidate;
+                result.kind = kind;
+                return true;
+            }
+            return false;
+        };
+
+        // group the tree edges by label. Label 0 is a bridge, a label shared with a non-tree edge is a 2-edge cut with it
+        std::unordered_map<uint64_t, std::vector<int>> sharedLabels;
+        for (int node = 0; node < nodeCount; node++) {
+            if (forest.parent[node] == -1) {
+                continue;
+            }
+            int64_t size = forest.subtreeSize[node];
+            uint64_t label = forest.label[node];
+            if (label == 0) {
+                if (consider("bridge", {1, std::min(size, nodeCount - size)})) {
+                    treeEdges = {node, -1};
+                }
+                continue;
+            }
+            if (forest.nonTreeLabels.count(label) && consider("2-edge", {2, std::min(size, nodeCount - size)})) {
+                treeEdges = {node, -1};
+            }
+            sharedLabels[label].push_back(node);
+        }
+        // tree edges with the same label lie on one root path, so removing two of them cuts off the band of subtree between them.
+        // Sorted from the top down the subtrees shrink, so the band closest to half the graph is found by binary search
+        for (auto& [label, nodes] : sharedLabels) {
+            if (nodes.size() < 2) {
+                continue;
+            }
+            std::sort(nodes.begin(), nodes.end(), [&forest](int left, int right) {
+                return forest.pre[left] < forest.pre[right];
+            });
+            for (size_t upper = 0; upper + 1 < nodes.size(); upper++) {
+                int64_t upperSize = forest.subtreeSize[nodes[upper]];
+                // the first lower edge whose band is at least half the graph, and the one before it
+                auto split = std::partition_point(nodes.begin() + upper + 1, nodes.end(), [&](int lower) {
+                    return 2 * (upperSize - forest.subtreeSize[lower]) < nodeCount;
+                });
+                for (auto lower : {split - 1, split}) {
+                    if (lower <= nodes.begin() + upper || lower == nodes.end()) {
+                        continue;
+                    }
+                    int64_t size = upperSize - forest.subtreeSize[*lower];
+                    if (consider("2-edge", {2, std::min(size, nodeCount - size)})) {
+                        treeEdges = {nodes[upper], *lower};
+                    }
+                }
+            }
+        }
+
+        std::vector<int> byDegree(nodeCount);
+        for (int node = 0; node < nodeCount; node++) {
+            byDegree[node] = node;
+        }
+        std::stable_sort(byDegree.begin(), byDegree.end(), [&graph](int left, int right) {
+            return graph.neighbors(left).size() < graph.neighbors(right).size();
+        });
+        auto [degreeLength, degreeCut] = bestPrefix(graph, byDegree);
+        if (consider("degree sweep", degreeCut)) {
+            treeEdges = {-1, -1};
+            sweepOrder = std::move(byDegree);
+            sweepLength = degreeLength;
+        }
+        int start = 0;
+        for (int sweep = 0; sweep < BFS_SWEEPS; sweep++) {
+            std::vector<int> order = bfsOrder(graph, start);
+            start = order.back();
+            auto [length, cut] = bestPrefix(graph, order);
+            if (consider("BFS sweep", cut)) {
+                treeEdges = {-1, -1};
+                sweepOrder = std::move(order);
+                sweepLength = length;
+            }
+        }
+
+        if (treeEdges.first != -1) {
+            auto subtree = [&forest](int node) {
+                auto start = forest.preorder.begin() + forest.pre[node];
+                return std::make_pair(start, start + forest.subtreeSize[node]);
+            };
+            auto [upperStart, upperEnd] = subtree(treeEdges.first);
+            if (treeEdges.second == -1) {
+                result.side.assign(upperStart, upperEnd);
+            } else {
+                auto [lowerStart, lowerEnd] = subtree(treeEdges.second);
+                result.side.assign(upperStart, lowerStart);
+                result.side.insert(result.side.end(), lowerEnd, upperEnd);
+            }
+        } else {
+            result.side.assign(sweepOrder.begin(), sweepOrder.begin() + sweepLength);
+        }
+    }
+
+    std::sort(result.side.begin(), result.side.end());
+    result.cutEdges = countCutEdges(graph, result.side);
+    result.smallerSide = std::min<int64_t>(result.side.size(), nodeCount - result.side.size());
+    result.expansion = static_cast<double>(result.cutEdges) / result.smallerSide;
+    return result;
+}
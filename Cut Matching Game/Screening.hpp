@@ -0,0 +1,39 @@
+//
+//  Screening.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Cheap checks for sparse cuts that are run before the game, so graphs with an obvious bottleneck don't need a single max flow.
+// Everything here is linear in the size of the graph (up to sorting):
+// - connected components
+// - bridges and 2-edge cuts, found by labeling every non-tree edge of a DFS tree with a random 64 bit value. A tree edge's label
+//   is the XOR of the non-tree edges crossing it, so bridges have label 0, and two edges with the same label form a 2-edge cut
+//   (with high probability, and the cut that's returned is counted exactly anyway)
+// - sweep cuts: the sparsest prefix of the nodes sorted by degree, and of a few BFS orders from far apart nodes
+// If nothing turns up, the graph goes to the game unchanged.
+
+#ifndef Screening_hpp
+#define Screening_hpp
+
+#include "Graph.hpp"
+#include <cstdint>
+#include <optional>
+
+struct ScreeningResult {
+    // which check found the cut, e.g. "bridge"
+    const char* kind = "";
+    // the side of the cut that was found (not necessarily the smaller one)
+    Subset side;
+    int64_t cutEdges;
+    int64_t smallerSide;
+    // cutEdges over smallerSide
+    double expansion;
+    // true if the cut is sparser than 1/phiInverse
+    bool sparserThan(int phiInverse) const;
+};
+
+// the sparsest cut any of the checks found, or nothing if the graph has fewer than 2 nodes
+std::optional<ScreeningResult> screenForSparseCut(const Graph& graph);
+
+#endif /* Screening_hpp */
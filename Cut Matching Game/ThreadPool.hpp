@@ -0,0 +1,49 @@
+//
+//  ThreadPool.hpp
+//  Cut Matching Game
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// A fixed set of worker threads pulling tasks off one queue in submission order.
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // threads <= 0 uses one thread per core
+    explicit ThreadPool(int threads);
+    // runs every task already submitted before joining the workers
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    int threadCount() const;
+
+    // queues task, the future holds its result (or whatever it threw)
+    template <typename Task>
+    auto submit(Task task) -> std::future<decltype(task())> {
+        auto packaged = std::make_shared<std::packaged_task<decltype(task())()>>(std::move(task));
+        std::future<decltype(task())> result = packaged->get_future();
+        this->enqueue([packaged] { (*packaged)(); });
+        return result;
+    }
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    void enqueue(std::function<void()> task);
+    void work();
+};
+
+#endif /* ThreadPool_hpp */
@@ -9,50 +9,92 @@
 #include "Graph.hpp"
 #include "Game.hpp"
 #include "MaxFlow.hpp"
+#include "MemoryProfile.hpp"
+#include "CommandLine.hpp"
+#include "Daemon.hpp"
+#include "PhiSearch.hpp"
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <string>
+#include <vector>
 
 
 #include <random>
 
+// cmg --serve socket [--workers #games] [--graph-cache #graphs]
+int serve(const std::vector<std::string>& args) {
+    DaemonOptions options;
+    options.socketPath = args[0];
+    for (size_t index = 1; index < args.size(); index++) {
+        bool hasValue = index + 1 < args.size();
+        if (args[index] == "--workers" && hasValue) {
+            options.workers = atoi(args[++index].c_str());
+        } else if (args[index] == "--graph-cache" && hasValue) {
+            options.graphCacheSize = atoi(args[++index].c_str());
+        } else {
+            std::cerr << "Unknown or incomplete daemon flag " << args[index] << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    Daemon daemon(options);
+    return daemon.serve() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int main(int argc, const char * argv[]) {
-    if (argc != 3 && argc != 4) {
-        std::cerr << "Expected 2 or 3  arguments: 1/phi, file, and #random_vectors (OPTIONAL)\n";
-        return EXIT_FAILURE;
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.size() >= 2 && args[0] == "--serve") {
+        return serve(std::vector<std::string>(args.begin() + 1, args.end()));
+    }
+    if (args.size() >= 2 && args[0] == "--connect") {
+        return runClient(args[1], std::vector<std::string>(args.begin() + 2, args.end()));
     }
     
-    int phiInverse = atoi(argv[1]);
-    
-    // use -1 as an value for infinite if not present
-    int randomVectorCount = -1;
-    if (argc == 4) {
-        randomVectorCount = atoi(argv[3]);
+    std::optional<Invocation> invocation = parseInvocation(args, std::cerr);
+    if (!invocation) {
+        std::cerr << "Or: --serve socket [--workers #games] [--graph-cache #graphs] to run a daemon, and --connect socket (then the usual arguments) to play a game on it\n";
+        return EXIT_FAILURE;
     }
+    GameOptions& options = invocation->options;
+    const char* inputPath = invocation->inputPath.c_str();
     
-    std::ifstream file(argv[2]);
-    std::stringstream fileBuffer;
+    if (options.memoryProfile && !MemoryProfile::available()) {
+        std::cerr << "Warning: built without -DCMG_MEMORY_PROFILE, only peak RSS will be reported\n";
+    }
     
-    if (file.is_open()) {
-        fileBuffer << file.rdbuf();
-    } else {
-        std::cerr << "Error opening file (" << argv[2] <<"): " << strerror(errno) << "\n" ;
+    std::optional<LoadedGraph> loaded = loadGraph(inputPath, invocation->ordering, std::cout);
+    if (!loaded) {
         return EXIT_FAILURE;
     }
-    file.close();
-    
-    Graph graph(fileBuffer);
+    Graph& graph = loaded->graph;
+    if (loaded->order) {
+        options.vertexOrder = &*loaded->order;
+    }
     int originalNodeCount = graph.nodeCount();
     //graph.displayDOT();
     bool SUBDIVIDE = false;
-    if (SUBDIVIDE) {
+    if (invocation->phiSearchLimit != 0) {
+        PhiSearch search(graph, options, invocation->phiSearchLimit, invocation->witnessPath);
+        if (!search.run()) {
+            return EXIT_FAILURE;
+        }
+    } else if (SUBDIVIDE) {
         graph.subdivideGraph();
         // initialize game, with index[nodes] being where the first split node starts and index[graph.nodeCount()] being right after the last split node
-        Game game(graph, originalNodeCount, graph.nodeCount(), phiInverse, randomVectorCount);
-        game.run();
+        Game game(graph, originalNodeCount, graph.nodeCount(), options);
+        if (!game.run()) {
+            return EXIT_FAILURE;
+        }
     } else {
         // don't subdivide, so set all the original nodes as "active" (can be considered for the cut
-        Game game(graph, 0, graph.nodeCount(), phiInverse, randomVectorCount);
-        game.run();
+        Game game(graph, 0, graph.nodeCount(), options);
+        if (!game.run()) {
+            return EXIT_FAILURE;
+        }
+    }
+    
+    if (options.memoryProfile) {
+        MemoryProfile::reportSummary(std::cout);
     }
     
     return EXIT_SUCCESS;
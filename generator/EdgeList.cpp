@@ -0,0 +1,196 @@
+//
+//  EdgeList.cpp
+//  generator
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "EdgeList.hpp"
+#include "../Cut Matching Game/CSRFormat.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+// rows are handed out in blocks so one thread doesn't get stuck with all the big rows (e.g. a clique)
+const uint64_t ROW_BLOCK = 4096;
+// roughly how many arcs each thread formats per batch when writing Chaco, so the text never has to fit in memory all at once
+const uint64_t CHACO_ARCS_PER_BATCH = 1 << 20;
+// arcs are grouped by their source's bucket of 2^BUCKET_BITS nodes before being counted/placed,
+// so the writes for one bucket stay in cache instead of landing all over a multi-GB array
+const int BUCKET_BITS = 12;
+const size_t EDGES_PER_CHUNK = 1 << 22;
+
+// calls visit(from, to) for both arcs of every edge (skipping self loops), a chunk of edges at a time, grouped by bucket of `from`
+template <typename Visit>
+void forEachArcByBucket(const EdgeBuffer& buffer, uint64_t nodeCount, Visit visit) {
+    size_t bucketCount = (nodeCount >> BUCKET_BITS) + 1;
+    std::vector<size_t> bucketStart(bucketCount + 1);
+    EdgeBuffer grouped;
+    for (size_t chunkStart = 0; chunkStart < buffer.size(); chunkStart += EDGES_PER_CHUNK) {
+        size_t chunkEnd = std::min(chunkStart + EDGES_PER_CHUNK, buffer.size());
+
+        std::fill(bucketStart.begin(), bucketStart.end(), 0);
+        for (size_t edge = chunkStart; edge < chunkEnd; edge++) {
+            auto [u, v] = buffer[edge];
+            if (u != v) {
+                bucketStart[(u >> BUCKET_BITS) + 1]++;
+                bucketStart[(v >> BUCKET_BITS) + 1]++;
+            }
+        }
+        std::partial_sum(bucketStart.begin(), bucketStart.end(), bucketStart.begin());
+        grouped.resize(bucketStart.back());
+        for (size_t edge = chunkStart; edge < chunkEnd; edge++) {
+            auto [u, v] = buffer[edge];
+            if (u != v) {
+                grouped[bucketStart[u >> BUCKET_BITS]++] = {u, v};
+                grouped[bucketStart[v >> BUCKET_BITS]++] = {v, u};
+            }
+        }
+
+        for (auto [from, to] : grouped) {
+            visit(from, to);
+        }
+    }
+}
+
+}
+
+CSRGraph buildCSR(uint64_t nodeCount, std::vector<EdgeBuffer>& buffers, int threads) {
+    CSRGraph graph;
+    graph.nodeCount = nodeCount;
+    int bufferCount = static_cast<int>(buffers.size());
+
+    // count both directions of every edge
+    std::vector<std::atomic<uint32_t>> counts(nodeCount);
+    parallelFor(bufferCount, [&](int thread) {
+        forEachArcByBucket(buffers[thread], nodeCount, [&counts](uint32_t from, uint32_t) {
+            counts[from].fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+
+    graph.offsets.resize(nodeCount + 1);
+    graph.offsets[0] = 0;
+    for (uint64_t node = 0; node < nodeCount; node++) {
+        graph.offsets[node + 1] = graph.offsets[node] + counts[node].load(std::memory_order_relaxed);
+        // reuse the counts as each row's fill cursor
+        counts[node].store(0, std::memory_order_relaxed);
+    }
+
+    graph.neighbors.resize(graph.offsets[nodeCount]);
+    parallelFor(bufferCount, [&](int thread) {
+        forEachArcByBucket(buffers[thread], nodeCount, [&graph, &counts](uint32_t from, uint32_t to) {
+            graph.neighbors[graph.offsets[from] + counts[from].fetch_add(1, std::memory_order_relaxed)] = to;
+        });
+        EdgeBuffer().swap(buffers[thread]);
+    });
+
+    // sort every row and drop duplicate edges, remembering each row's new length
+    std::vector<uint64_t> uniqueDegree(nodeCount);
+    std::atomic<uint64_t> nextBlock = 0;
+    parallelFor(threads, [&](int) {
+        uint64_t start;
+        while ((start = nextBlock.fetch_add(ROW_BLOCK)) < nodeCount) {
+            uint64_t end = std::min(start + ROW_BLOCK, nodeCount);
+            for (uint64_t node = start; node < end; node++) {
+                auto rowBegin = graph.neighbors.begin() + graph.offsets[node];
+                auto rowEnd = graph.neighbors.begin() + graph.offsets[node + 1];
+                std::sort(rowBegin, rowEnd);
+                uniqueDegree[node] = std::unique(rowBegin, rowEnd) - rowBegin;
+            }
+        }
+    });
+
+    // compact in place. Rows only ever move left, so going in order never overwrites a row we haven't moved yet
+    uint64_t write = 0;
+    for (uint64_t node = 0; node < nodeCount; node++) {
+        uint64_t read = graph.offsets[node];
+        if (read != write) {
+            std::memmove(&graph.neighbors[write], &graph.neighbors[read], uniqueDegree[node] * sizeof(uint32_t));
+        }
+        graph.offsets[node] = write;
+        write += uniqueDegree[node];
+    }
+    graph.offsets[nodeCount] = write;
+    graph.neighbors.resize(write);
+    graph.neighbors.shrink_to_fit();
+    return graph;
+}
+
+bool writeChaco(const CSRGraph& graph, const std::string& path, int threads) {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        std::cerr << "Error opening " << path << " for writing: " << strerror(errno) << "\n";
+        return false;
+    }
+    output << graph.nodeCount << " " << graph.edgeCount() << "\n";
+
+    std::vector<std::string> chunks(threads);
+    uint64_t start = 0;
+    while (start < graph.nodeCount) {
+        // split the next batch of rows between the threads by arc count
+        std::vector<uint64_t> bounds = {start};
+        for (int thread = 0; thread < threads; thread++) {
+            uint64_t from = bounds.back();
+            uint64_t targetArc = graph.offsets[from] + CHACO_ARCS_PER_BATCH;
+            uint64_t to = std::upper_bound(graph.offsets.begin() + from, graph.offsets.end() - 1, targetArc) - graph.offsets.begin();
+            bounds.push_back(std::min(std::max(to, from + 1), graph.nodeCount));
+        }
+
+        parallelFor(threads, [&](int thread) {
+            std::string& chunk = chunks[thread];
+            chunk.clear();
+            char number[16];
+            for (uint64_t node = bounds[thread]; node < bounds[thread + 1]; node++) {
+                for (uint64_t arc = graph.offsets[node]; arc < graph.offsets[node + 1]; arc++) {
+                    if (arc != graph.offsets[node]) {
+                        chunk.push_back(' ');
+                    }
+                    // nodes are 1-indexed in Chaco
+                    auto result = std::to_chars(number, number + sizeof(number), graph.neighbors[arc] + 1ull);
+                    chunk.append(number, result.ptr);
+                }
+                chunk.push_back('\n');
+            }
+        });
+
+        for (const auto& chunk : chunks) {
+            output.write(chunk.data(), chunk.size());
+        }
+        start = bounds.back();
+    }
+
+    if (!output) {
+        std::cerr << "Error writing " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool writeCSR(const CSRGraph& graph, const std::string& path) {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        std::cerr << "Error opening " << path << " for writing: " << strerror(errno) << "\n";
+        return false;
+    }
+    CSRHeader header = {};
+    std::copy(CSR_MAGIC, CSR_MAGIC + sizeof(CSR_MAGIC), header.magic);
+    header.version = CSR_VERSION;
+    header.nodeCount = graph.nodeCount;
+    header.arcCount = graph.neighbors.size();
+
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(graph.offsets.data()), graph.offsets.size() * sizeof(uint64_t));
+    output.write(reinterpret_cast<const char*>(graph.neighbors.data()), graph.neighbors.size() * sizeof(uint32_t));
+
+    if (!output) {
+        std::cerr << "Error writing " << path << "\n";
+        return false;
+    }
+    return true;
+}
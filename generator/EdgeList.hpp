@@ -0,0 +1,51 @@
+//
+//  EdgeList.hpp
+//  generator
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Edges are generated into one buffer per thread, then turned into a deduplicated CSR graph with parallel counting/scattering
+
+#ifndef EdgeList_hpp
+#define EdgeList_hpp
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using EdgeBuffer = std::vector<std::pair<uint32_t, uint32_t>>;
+
+struct CSRGraph {
+    uint64_t nodeCount = 0;
+    // row offsets, nodeCount + 1 of them
+    std::vector<uint64_t> offsets;
+    // every undirected edge is stored in both rows, each row sorted
+    std::vector<uint32_t> neighbors;
+    uint64_t edgeCount() const { return neighbors.size() / 2; }
+};
+
+// builds the CSR from per-thread edge buffers, dropping self loops and duplicate edges
+// frees the buffers as it goes, since at 10^8 edges we can't afford to keep both around
+CSRGraph buildCSR(uint64_t nodeCount, std::vector<EdgeBuffer>& buffers, int threads);
+
+// Chaco format (1-indexed, unweighted), the same thing build_graph.py writes
+bool writeChaco(const CSRGraph& graph, const std::string& path, int threads);
+// binary format from CSRFormat.hpp, which cmg can load without parsing
+bool writeCSR(const CSRGraph& graph, const std::string& path);
+
+// runs body(thread) on `threads` threads and waits for all of them
+template <typename Body>
+void parallelFor(int threads, Body body) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int thread = 0; thread < threads; thread++) {
+        workers.emplace_back(body, thread);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+#endif /* EdgeList_hpp */
@@ -0,0 +1,177 @@
+//
+//  Families.cpp
+//  generator
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+
+#include "Families.hpp"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// each thread (or cycle) gets its own stream, derived from the seed so runs are reproducible
+std::mt19937_64 streamFor(const FamilyOptions& options, uint64_t stream) {
+    std::seed_seq seq{options.seed, stream};
+    return std::mt19937_64(seq);
+}
+
+// every edge of the clique on [begin, end). Rows are striped across threads since the first rows are the longest
+void addClique(uint64_t begin, uint64_t end, int thread, int threads, EdgeBuffer& buffer) {
+    for (uint64_t u = begin + thread; u < end; u += threads) {
+        for (uint64_t v = u + 1; v < end; v++) {
+            buffer.emplace_back(u, v);
+        }
+    }
+}
+
+// union of degree / 2 random Hamiltonian cycles on [begin, end) (plus a random perfect matching if degree is odd),
+// so every node has degree `degree` until duplicate edges are dropped. Cycles are spread across the threads
+void addRandomRegular(const FamilyOptions& options, uint64_t begin, uint64_t end, uint64_t streamOffset, int thread, int threads, EdgeBuffer& buffer) {
+    uint64_t size = end - begin;
+    int cycles = options.degree / 2;
+    bool addMatching = options.degree % 2 == 1;
+    std::vector<uint32_t> order(size);
+    for (int layer = thread; layer < cycles + (addMatching ? 1 : 0); layer += threads) {
+        std::mt19937_64 rng = streamFor(options, streamOffset + layer);
+        std::iota(order.begin(), order.end(), static_cast<uint32_t>(begin));
+        std::shuffle(order.begin(), order.end(), rng);
+        if (layer < cycles) {
+            for (uint64_t index = 0; index < size; index++) {
+                buffer.emplace_back(order[index], order[(index + 1) % size]);
+            }
+        } else {
+            for (uint64_t index = 0; index + 1 < size; index += 2) {
+                buffer.emplace_back(order[index], order[index + 1]);
+            }
+        }
+    }
+}
+
+bool generateLine(const FamilyOptions& options, std::vector<EdgeBuffer>& buffers) {
+    int threads = static_cast<int>(buffers.size());
+    parallelFor(threads, [&](int thread) {
+        for (uint64_t node = 1 + thread; node < options.nodes; node += threads) {
+            buffers[thread].emplace_back(node - 1, node);
+        }
+    });
+    return true;
+}
+
+bool generateStar(const FamilyOptions& options, std::vector<EdgeBuffer>& buffers) {
+    int threads = static_cast<int>(buffers.size());
+    parallelFor(threads, [&](int thread) {
+        for (uint64_t node = 1 + thread; node < options.nodes; node += threads) {
+            buffers[thread].emplace_back(0, node);
+        }
+    });
+    return true;
+}
+
+// two cliques on each half of the nodes, joined by crossEdges edges ((mid - 1, mid), (mid - 2, mid + 1), ...)
+bool generateDumbbell(const FamilyOptions& options, std::vector<EdgeBuffer>& buffers) {
+    if (options.nodes % 2 != 0) {
+        std::cerr << "Nodes must be divisible by 2\n";
+        return false;
+    }
+    uint64_t midpoint = options.nodes / 2;
+    if (options.crossEdges > midpoint) {
+        std::cerr << "Can't join two cliques of " << midpoint << " nodes with " << options.crossEdges << " disjoint edges\n";
+        return false;
+    }
+    int threads = static_cast<int>(buffers.size());
+    parallelFor(threads, [&](int thread) {
+        addClique(0, midpoint, thread, threads, buffers[thread]);
+        addClique(midpoint, options.nodes, thread, threads, buffers[thread]);
+        for (uint64_t bridge = thread; bridge < options.crossEdges; bridge += threads) {
+            buffers[thread].emplace_back(midpoint - 1 - bridge, midpoint + bridge);
+        }
+    });
+    return true;
+}
+
+// gen_barbell.py: the dumbbell with a single bridge
+bool generateBarbell(const FamilyOptions& options, std::vector<EdgeBuffer>& buffers) {
+    FamilyOptions barbell = options;
+    barbell.crossEdges = 1;
+    return generateDumbbell(barbell, buffers);
+}
+
+// gen.py: `edges` uniformly random edges. Self loops and repeats are dropped afterwards, so there can be slightly fewer
+bool generateRandom(const FamilyOptions& options, std::vector<EdgeBuffer>& buffers) {
+    if (options.nodes < 2) {
+        std::cerr << "Need at least 2 nodes for random edges\n";
+        return false;
+    }
+    int threads = static_cast<int>(buffers.size());
+    parallelFor(threads, [&](int thread) {
+        std::mt19937_64 rng = streamFor(options, thread);
+        std::uniform_int_distribution<uint64_t> pick(0, options.nodes - 1);
+        uint64_t share = options.edges / threads + (static_cast<uint64_t>(thread) < options.edges % threads ? 1 : 0);
+        buffers[thread].reserve(share);
+        for (uint64_t edge = 0; edge < share; edge++) {
+            buffers[thread].emplace_back(pick(rng), pick(rng));
+        }
+    });
+    return true;
+}
+
+bool generateRegular(const FamilyOptions& options, std::vector<EdgeBuffer>& buffers) {
+    if (options.degree < 1 || (options.degree % 2 == 1 && options.nodes % 2 == 1)) {
+        std::cerr << "Need a positive degree, and an even number of nodes for an odd degree\n";
+        return false;
+    }
+    int threads = static_cast<int>(buffers.size());
+    parallelFor(threads, [&](int thread) {
+        addRandomRegular(options, 0, options.nodes, 0, thread, threads, buffers[thread]);
+    });
+    return true;
+}
+
+// random regular graphs on each half of the nodes, with crossEdges random edges between them.
+// The halves are expanders (w.h.p.), so the cut between them has edge expansion crossEdges / (nodes / 2)
+bool generatePlanted(const FamilyOptions& options, std::vector<EdgeBuffer>& buffers) {
+    uint64_t half = options.nodes / 2;
+    if (options.nodes % 2 != 0 || options.degree < 1 || (options.degree % 2 == 1 && half % 2 == 1)) {
+        std::cerr << "Nodes must be divisible by 2 (and by 4 for an odd degree), with a positive degree\n";
+        return false;
+    }
+    int threads = static_cast<int>(buffers.size());
+    parallelFor(threads, [&](int thread) {
+        addRandomRegular(options, 0, half, 0, thread, threads, buffers[thread]);
+        addRandomRegular(options, half, options.nodes, options.degree, thread, threads, buffers[thread]);
+        std::mt19937_64 rng = streamFor(options, 2 * options.degree + thread);
+        std::uniform_int_distribution<uint64_t> pick(0, half - 1);
+        for (uint64_t edge = thread; edge < options.crossEdges; edge += threads) {
+            buffers[thread].emplace_back(pick(rng), half + pick(rng));
+        }
+    });
+    return true;
+}
+
+}
+
+const std::vector<Family>& families() {
+    static const std::vector<Family> all = {
+        {"line", "path on n nodes", generateLine},
+        {"star", "star with node 1 at the center", generateStar},
+        {"barbell", "two n/2 cliques joined by one edge", generateBarbell},
+        {"dumbbell", "two n/2 cliques joined by k edges", generateDumbbell},
+        {"random", "m uniformly random edges", generateRandom},
+        {"regular", "random d-regular expander (union of random cycles, duplicates dropped)", generateRegular},
+        {"planted", "two random d-regular halves joined by k random edges, phi = k / (n/2)", generatePlanted},
+    };
+    return all;
+}
+
+const Family* findFamily(const std::string& name) {
+    for (const Family& family : families()) {
+        if (name == family.name) {
+            return &family;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,39 @@
+//
+//  Families.hpp
+//  generator
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Graph families from scripts/ (gen_line.py, build_star.py, gen_barbell.py, build_expanders.py, gen.py),
+// plus random near d-regular expanders and planted sparse cuts
+
+#ifndef Families_hpp
+#define Families_hpp
+
+#include "EdgeList.hpp"
+#include <string>
+#include <vector>
+
+struct FamilyOptions {
+    uint64_t nodes = 100;
+    // random: how many edges to sample
+    uint64_t edges = 1000;
+    // regular/planted: degree of each node (before dropping duplicate edges)
+    int degree = 8;
+    // dumbbell: how many edges join the cliques. planted: how many edges cross the planted cut
+    uint64_t crossEdges = 1;
+    uint64_t seed = 0;
+    int threads = 1;
+};
+
+struct Family {
+    const char* name;
+    const char* description;
+    // fills one edge buffer per thread. Returns false (after printing why) if the options don't make sense for the family
+    bool (*generate)(const FamilyOptions& options, std::vector<EdgeBuffer>& buffers);
+};
+
+const std::vector<Family>& families();
+const Family* findFamily(const std::string& name);
+
+#endif /* Families_hpp */
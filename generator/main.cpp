@@ -0,0 +1,117 @@
+//
+//  main.cpp
+//  generator
+//
+//  Created by Lucas Kellar on 10/19/26.
+//
+// Native replacement for the graph scripts in scripts/, for building inputs too big for Python
+
+#include "EdgeList.hpp"
+#include "Families.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: cmg-gen family output [-n #nodes] [-m #edges] [-d degree] [-k #crossEdges] [--seed seed] [--threads #threads] [--format chaco|csr]\n";
+    std::cerr << "Families:\n";
+    for (const Family& family : families()) {
+        std::cerr << "  " << family.name << ": " << family.description << "\n";
+    }
+    std::cerr << "The format defaults to csr if output ends in .csr, chaco otherwise\n";
+}
+
+}
+
+int main(int argc, const char * argv[]) {
+    FamilyOptions options;
+    options.seed = std::random_device()();
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string format;
+    std::vector<std::string> positional;
+
+    for (int index = 1; index < argc; index++) {
+        std::string arg = argv[index];
+        bool hasValue = index + 1 < argc;
+        if ((arg == "-n" || arg == "--nodes") && hasValue) {
+            options.nodes = std::strtoull(argv[++index], nullptr, 10);
+        } else if ((arg == "-m" || arg == "--edges") && hasValue) {
+            options.edges = std::strtoull(argv[++index], nullptr, 10);
+        } else if ((arg == "-d" || arg == "--degree") && hasValue) {
+            options.degree = atoi(argv[++index]);
+        } else if ((arg == "-k" || arg == "--cross-edges") && hasValue) {
+            options.crossEdges = std::strtoull(argv[++index], nullptr, 10);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++index], nullptr, 10);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::max(1, atoi(argv[++index]));
+        } else if (arg == "--format" && hasValue) {
+            format = argv[++index];
+        } else if (arg.starts_with("-")) {
+            std::cerr << "Unknown or incomplete flag " << arg << "\n";
+            printUsage();
+            return EXIT_FAILURE;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() != 2) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    const Family* family = findFamily(positional[0]);
+    if (family == nullptr) {
+        std::cerr << "Unknown family " << positional[0] << "\n";
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    const std::string& output = positional[1];
+    if (format.empty()) {
+        format = output.ends_with(".csr") ? "csr" : "chaco";
+    }
+    if (format != "chaco" && format != "csr") {
+        std::cerr << "Unknown format " << format << "\n";
+        return EXIT_FAILURE;
+    }
+    if (options.nodes == 0 || options.nodes > std::numeric_limits<uint32_t>::max()) {
+        std::cerr << "Node count must be between 1 and " << std::numeric_limits<uint32_t>::max() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start] {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::vector<EdgeBuffer> buffers(options.threads);
+    if (!family->generate(options, buffers)) {
+        return EXIT_FAILURE;
+    }
+    CSRGraph graph = buildCSR(options.nodes, buffers, options.threads);
+    std::cout << "Generated " << family->name << " with " << graph.nodeCount << " nodes and " << graph.edgeCount() << " edges in " << elapsed() << "s (seed " << options.seed << ")\n";
+
+    if (std::string(family->name) == "planted") {
+        // count what actually crosses, since repeated cross edges are dropped
+        uint64_t half = graph.nodeCount / 2;
+        uint64_t crossing = 0;
+        for (uint64_t node = 0; node < half; node++) {
+            for (uint64_t arc = graph.offsets[node]; arc < graph.offsets[node + 1]; arc++) {
+                crossing += graph.neighbors[arc] >= half ? 1 : 0;
+            }
+        }
+        std::cout << "Planted cut: nodes 1.." << half << " vs the rest, " << crossing << " crossing edges, phi = " << static_cast<double>(crossing) / half << "\n";
+    }
+
+    bool written = format == "csr" ? writeCSR(graph, output) : writeChaco(graph, output, options.threads);
+    if (!written) {
+        return EXIT_FAILURE;
+    }
+    std::cout << "Wrote " << output << " (" << format << ") after " << elapsed() << "s\n";
+    return EXIT_SUCCESS;
+}
@@ -1,4 +1,5 @@
 #!/bin/sh
 
 DIR="Cut Matching Game"
-g++ -std=gnu++20 -O3 -Wall -Wextra "$DIR/main.cpp" "$DIR/EdmondsKarpMaxflow.cpp" "$DIR/PushRelabelMaxFlow.cpp" "$DIR/MaxFlow.cpp" "$DIR/Game.cpp" "$DIR/Graph.cpp" -o cmg
\ No newline at end of file
+g++ -std=gnu++20 -O3 -Wall -Wextra -pthread "$DIR/main.cpp" "$DIR/EdmondsKarpMaxFlow.cpp" "$DIR/PushRelabelMaxFlow.cpp" "$DIR/MaxFlow.cpp" "$DIR/Game.cpp" "$DIR/Graph.cpp" "$DIR/Checkpoint.cpp" "$DIR/Certificate.cpp" "$DIR/MemoryProfile.cpp" "$DIR/CommandLine.cpp" "$DIR/ThreadPool.cpp" "$DIR/GraphCache.cpp" "$DIR/Daemon.cpp" "$DIR/PhiSearch.cpp" "$DIR/Reordering.cpp" "$DIR/ProjectionVector.cpp" "$DIR/FlowKernel.cpp" "$DIR/Screening.cpp" "$DIR/CutPlayer.cpp" -o cmg "$@"
+g++ -std=gnu++20 -O3 -Wall -Wextra -pthread generator/main.cpp generator/Families.cpp generator/EdgeList.cpp -o cmg-gen
@@ -0,0 +1,130 @@
+# Checks an embedding certificate written by `cmg --certificate`
+# against the graph it was written for
+#
+# Layout (little endian, no padding):
+#   magic "CMGCERT\0", uint32 version, int32 nodes, int32 phiInverse, uint32 rounds,
+#   uint64 graph fingerprint, uint64 edges, uint64 paths, uint64 path edges, uint32 max congestion
+#   edges x (int32 u, int32 v)          edge ids, u < v, 0-indexed
+#   (rounds + 1) x uint64               first path of each round
+#   paths x (int32 from, int32 to)      the matched pair each path embeds
+#   (paths + 1) x uint64                first edge of each path
+#   path edges x int32                  edge ids of every path, back to back
+
+import struct
+import sys
+from array import array
+from collections import Counter
+from argparse import ArgumentParser
+import pathlib
+
+parser = ArgumentParser(prog='verify_certificate')
+parser.add_argument('graph', type=pathlib.Path)
+parser.add_argument('certificate', type=pathlib.Path)
+
+args = parser.parse_args()
+
+CSR_MAGIC = b'CMGCSR\0\0'
+CERT_MAGIC = b'CMGCERT\0'
+HEADER = '<8sIiiIQQQQI'
+
+def fail(message):
+    print(f'INVALID: {message}')
+    sys.exit(1)
+
+def readArray(data, offset, typecode, count):
+    values = array(typecode)
+    values.frombytes(data[offset:offset + count * values.itemsize])
+    if len(values) != count:
+        fail('certificate is truncated')
+    return values, offset + count * values.itemsize
+
+# returns every node's neighbors in file order, without self loops, like cmg loads them
+def loadGraph(path):
+    data = path.read_bytes()
+    if data.startswith(CSR_MAGIC):
+        _, _, _, nodes, arcs = struct.unpack_from('<8sIIQQ', data, 0)
+        offsets, position = readArray(data, 32, 'Q', nodes + 1)
+        neighbors, _ = readArray(data, position, 'I', arcs)
+        return [[v for v in neighbors[offsets[u]:offsets[u + 1]] if v != u] for u in range(nodes)]
+    lines = data.decode().split('\n')
+    nodes = int(lines[0].split()[0])
+    adjacency = [[] for _ in range(nodes)]
+    for u, line in enumerate(lines[1:nodes + 1]):
+        adjacency[u] = [v for v in (int(token) - 1 for token in line.split()) if v != u]
+    return adjacency
+
+# the FNV-1a hash of Graph::fingerprint, over the node count and every row (unit weights) followed by a separator
+def fingerprint(adjacency):
+    hash = 14695981039346656037
+    def mix(value):
+        nonlocal hash
+        for byte in value.to_bytes(8, 'little'):
+            hash = ((hash ^ byte) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    mix(len(adjacency))
+    for neighbors in adjacency:
+        for v in neighbors:
+            mix(v)
+            mix(1)
+        mix(0xFFFFFFFFFFFFFFFF)
+    return hash
+
+adjacency = loadGraph(args.graph)
+graphNodes = len(adjacency)
+# parallel edges are separate edges, so compare (u, v) pairs with u < v as multisets
+graphEdges = Counter((u, v) for u, neighbors in enumerate(adjacency) for v in neighbors if u < v)
+data = args.certificate.read_bytes()
+if len(data) < struct.calcsize(HEADER):
+    fail('certificate is truncated')
+magic, version, nodes, phiInverse, rounds, graphFingerprint, edgeCount, pathCount, pathEdgeCount, claimedCongestion = struct.unpack_from(HEADER, data, 0)
+if magic != CERT_MAGIC or version != 1:
+    fail('not a version 1 certificate')
+if nodes != graphNodes:
+    fail(f'certificate is for {nodes} nodes but the graph has {graphNodes}')
+if graphFingerprint != fingerprint(adjacency):
+    fail('certificate was written for a different graph (fingerprints differ)')
+
+position = struct.calcsize(HEADER)
+edgeEndpoints, position = readArray(data, position, 'i', 2 * edgeCount)
+roundOffsets, position = readArray(data, position, 'Q', rounds + 1)
+pathEndpoints, position = readArray(data, position, 'i', 2 * pathCount)
+pathOffsets, position = readArray(data, position, 'Q', pathCount + 1)
+pathEdges, position = readArray(data, position, 'i', pathEdgeCount)
+
+certificateEdges = Counter(zip(edgeEndpoints[0::2], edgeEndpoints[1::2]))
+if certificateEdges != graphEdges:
+    fail('edge table does not match the graph')
+
+congestion = [0] * edgeCount
+for round in range(rounds):
+    matched = set()
+    roundUse = {}
+    for path in range(roundOffsets[round], roundOffsets[round + 1]):
+        start, end = pathEndpoints[2 * path], pathEndpoints[2 * path + 1]
+        if start in matched or end in matched or start == end:
+            fail(f'round {round} is not a matching (node {start + 1} or {end + 1} used twice)')
+        matched.add(start)
+        matched.add(end)
+
+        current = start
+        for edge in pathEdges[pathOffsets[path]:pathOffsets[path + 1]]:
+            u, v = edgeEndpoints[2 * edge], edgeEndpoints[2 * edge + 1]
+            if current == u:
+                current = v
+            elif current == v:
+                current = u
+            else:
+                fail(f'path {path} in round {round} is not connected at node {current + 1}')
+            congestion[edge] += 1
+            roundUse[edge] = roundUse.get(edge, 0) + 1
+        if current != end:
+            fail(f'path {path} in round {round} ends at {current + 1} instead of {end + 1}')
+
+    overused = [edge for edge, used in roundUse.items() if used > phiInverse]
+    if overused:
+        fail(f'round {round} sends more than {phiInverse} paths through edge {overused[0]}')
+
+maxCongestion = max(congestion, default=0)
+if maxCongestion != claimedCongestion:
+    fail(f'claimed congestion {claimedCongestion} but the paths give {maxCongestion}')
+
+print(f'OK: {rounds} matchings ({pathCount} paths) embedded with congestion {maxCongestion}')